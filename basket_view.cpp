@@ -0,0 +1,150 @@
+#include "basket_view.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BASKET_HAVE_AVX2 1
+#endif
+
+// ── Dispatch ──────────────────────────────────────────────────────────────────
+
+#ifdef BASKET_HAVE_AVX2
+static const bool g_avx2 = __builtin_cpu_supports("avx2");
+#else
+static const bool g_avx2 = false;
+#endif
+
+bool basket_avx2_available() { return g_avx2; }
+
+BasketSums basket_sums(const int32_t* weight, const int32_t* bid, const int32_t* ask,
+                       size_t lanes, size_t count) {
+    return g_avx2 ? basket_sums_avx2  (weight, bid, ask, lanes, count)
+                  : basket_sums_scalar(weight, bid, ask, lanes, count);
+}
+
+int32_t basket_max_units(const int32_t* lots, const int32_t* position, const int32_t* limit,
+                         const int32_t* weight, int32_t sign, size_t lanes) {
+    return g_avx2 ? basket_max_units_avx2  (lots, position, limit, weight, sign, lanes)
+                  : basket_max_units_scalar(lots, position, limit, weight, sign, lanes);
+}
+
+static uint64_t low_bits(size_t count) {
+    return count >= 64 ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+}
+
+// ── Scalar ────────────────────────────────────────────────────────────────────
+
+BasketSums basket_sums_scalar(const int32_t* weight, const int32_t* bid, const int32_t* ask,
+                              size_t lanes, size_t count) {
+    BasketSums s{0, 0, 0, 0};
+    for (size_t i = 0; i < lanes; ++i) {
+        s.nav_bid     += weight[i] * bid[i];
+        s.nav_ask     += weight[i] * ask[i];
+        s.bid_missing |= static_cast<uint64_t>(bid[i] == 0) << i;
+        s.ask_missing |= static_cast<uint64_t>(ask[i] == 0) << i;
+    }
+    s.bid_missing &= low_bits(count);
+    s.ask_missing &= low_bits(count);
+    return s;
+}
+
+// The quotient goes through double: for int32 operands the correctly
+// rounded quotient never crosses an integer, so truncating it is exact.
+// The AVX2 kernel has no integer divide and does the same, so both agree.
+int32_t basket_max_units_scalar(const int32_t* lots, const int32_t* position, const int32_t* limit,
+                                const int32_t* weight, int32_t sign, size_t lanes) {
+    int32_t units = INT32_MAX;
+    for (size_t i = 0; i < lanes; ++i) {
+        int32_t room = limit[i] - sign * position[i];
+        int32_t n    = std::min(lots[i], room);
+        units = std::min(units, static_cast<int32_t>(static_cast<double>(n) / weight[i]));
+    }
+    return units;
+}
+
+// ── AVX2 ──────────────────────────────────────────────────────────────────────
+
+#ifdef BASKET_HAVE_AVX2
+
+__attribute__((target("avx2")))
+static inline __m256i load8(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+__attribute__((target("avx2")))
+static inline int32_t hsum(__m256i v) {
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+    return _mm_cvtsi128_si32(s);
+}
+
+__attribute__((target("avx2")))
+static inline int32_t hmin(__m256i v) {
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, 0x4E));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, 0xB1));
+    return _mm_cvtsi128_si32(m);
+}
+
+__attribute__((target("avx2")))
+static inline uint64_t zero_lanes(__m256i v) {
+    __m256i eq = _mm256_cmpeq_epi32(v, _mm256_setzero_si256());
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(eq)));
+}
+
+__attribute__((target("avx2")))
+BasketSums basket_sums_avx2(const int32_t* weight, const int32_t* bid, const int32_t* ask,
+                            size_t lanes, size_t count) {
+    __m256i  nav_bid = _mm256_setzero_si256();
+    __m256i  nav_ask = _mm256_setzero_si256();
+    uint64_t bid_missing = 0, ask_missing = 0;
+    for (size_t i = 0; i < lanes; i += 8) {
+        __m256i w = load8(weight + i);
+        __m256i b = load8(bid + i);
+        __m256i a = load8(ask + i);
+        nav_bid = _mm256_add_epi32(nav_bid, _mm256_mullo_epi32(w, b));
+        nav_ask = _mm256_add_epi32(nav_ask, _mm256_mullo_epi32(w, a));
+        bid_missing |= zero_lanes(b) << i;
+        ask_missing |= zero_lanes(a) << i;
+    }
+    return { hsum(nav_bid), hsum(nav_ask),
+             bid_missing & low_bits(count), ask_missing & low_bits(count) };
+}
+
+__attribute__((target("avx2")))
+int32_t basket_max_units_avx2(const int32_t* lots, const int32_t* position, const int32_t* limit,
+                              const int32_t* weight, int32_t sign, size_t lanes) {
+    __m256i s     = _mm256_set1_epi32(sign);
+    __m256i units = _mm256_set1_epi32(INT32_MAX);
+    for (size_t i = 0; i < lanes; i += 8) {
+        __m256i room = _mm256_sub_epi32(load8(limit + i), _mm256_sign_epi32(load8(position + i), s));
+        __m256i n    = _mm256_min_epi32(load8(lots + i), room);
+        __m256i w    = load8(weight + i);
+
+        // Two 4-lane double divides, truncated back to int32
+        __m256d q_lo = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(n)),
+                                     _mm256_cvtepi32_pd(_mm256_castsi256_si128(w)));
+        __m256d q_hi = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(n, 1)),
+                                     _mm256_cvtepi32_pd(_mm256_extracti128_si256(w, 1)));
+        __m256i q    = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(q_lo)),
+                                               _mm256_cvttpd_epi32(q_hi), 1);
+        units = _mm256_min_epi32(units, q);
+    }
+    return hmin(units);
+}
+
+#else
+
+BasketSums basket_sums_avx2(const int32_t* weight, const int32_t* bid, const int32_t* ask,
+                            size_t lanes, size_t count) {
+    return basket_sums_scalar(weight, bid, ask, lanes, count);
+}
+
+int32_t basket_max_units_avx2(const int32_t* lots, const int32_t* position, const int32_t* limit,
+                              const int32_t* weight, int32_t sign, size_t lanes) {
+    return basket_max_units_scalar(lots, position, limit, weight, sign, lanes);
+}
+
+#endif
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+
+// ── Basket kernels ────────────────────────────────────────────────────────────
+//
+// Vector kernels over a basket's legs, laid out as separate int32 arrays of
+// `lanes` entries (a multiple of 8, 32-byte aligned). Each has an AVX2
+// version and a scalar fallback. The unsuffixed entry points pick AVX2 once,
+// at startup, if the CPU has it.
+
+struct BasketSums {
+    int32_t  nav_bid;       // Σ weight × bid over all lanes
+    int32_t  nav_ask;       // Σ weight × ask over all lanes
+    uint64_t bid_missing;   // bit i: lane i has no bid (price 0)
+    uint64_t ask_missing;   // bit i: lane i has no ask
+};
+
+// NAV sums and missing masks; bits at and above `count` are cleared
+BasketSums basket_sums       (const int32_t* weight, const int32_t* bid, const int32_t* ask,
+                              size_t lanes, size_t count);
+BasketSums basket_sums_scalar(const int32_t* weight, const int32_t* bid, const int32_t* ask,
+                              size_t lanes, size_t count);
+BasketSums basket_sums_avx2  (const int32_t* weight, const int32_t* bid, const int32_t* ask,
+                              size_t lanes, size_t count);
+
+// Units every lane allows: min over i of min(lots[i], limit[i] − sign × position[i]) / weight[i],
+// sign +1 when buying the legs, −1 when selling them. Exact integer quotient.
+int32_t basket_max_units       (const int32_t* lots, const int32_t* position, const int32_t* limit,
+                                const int32_t* weight, int32_t sign, size_t lanes);
+int32_t basket_max_units_scalar(const int32_t* lots, const int32_t* position, const int32_t* limit,
+                                const int32_t* weight, int32_t sign, size_t lanes);
+int32_t basket_max_units_avx2  (const int32_t* lots, const int32_t* position, const int32_t* limit,
+                                const int32_t* weight, int32_t sign, size_t lanes);
+
+// True if the AVX2 kernels can run on this CPU
+bool basket_avx2_available();
+
+// ── BasketView ────────────────────────────────────────────────────────────────
+// Struct-of-arrays copy of a basket's legs, one aligned array per field.
+// Lanes past `count` hold neutral values — no price, unbounded lots and
+// limit, weight 1 — so kernels run whole 8-lane blocks without a tail.
+
+template <size_t N>
+struct BasketView {
+    static_assert(N % 8 == 0, "BasketView capacity must be a whole number of 8-lane blocks");
+    static_assert(N <= 64, "missing-leg masks are 64 bits");
+    static constexpr size_t CAPACITY = N;
+
+    size_t count = 0;
+    alignas(32) std::array<int32_t, N> bid_price;
+    alignas(32) std::array<int32_t, N> ask_price;
+    alignas(32) std::array<int32_t, N> bid_qty;
+    alignas(32) std::array<int32_t, N> ask_qty;
+    alignas(32) std::array<int32_t, N> position;
+    alignas(32) std::array<int32_t, N> limit;
+    alignas(32) std::array<int32_t, N> weight;   // lots per creation unit
+
+    void clear() {
+        count = 0;
+        bid_price.fill(0);       ask_price.fill(0);
+        bid_qty  .fill(INT32_MAX); ask_qty.fill(INT32_MAX);
+        position .fill(0);       limit.fill(INT32_MAX);
+        weight   .fill(1);
+    }
+
+    size_t lanes() const { return (count + 7) & ~size_t{7}; }
+
+    BasketSums sums() const {
+        return basket_sums(weight.data(), bid_price.data(), ask_price.data(), lanes(), count);
+    }
+
+    // Creation units the leg asks and our limits allow (buying the legs)
+    int32_t creation_units() const {
+        return basket_max_units(ask_qty.data(), position.data(), limit.data(),
+                                weight.data(), +1, lanes());
+    }
+
+    // Redemption units the leg bids and our limits allow (selling the legs)
+    int32_t redemption_units() const {
+        return basket_max_units(bid_qty.data(), position.data(), limit.data(),
+                                weight.data(), -1, lanes());
+    }
+};
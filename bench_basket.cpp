@@ -0,0 +1,72 @@
+// bench_basket.cpp
+// Basket kernels — NAV sums with missing masks, and the min-units reduction
+// used for leg sizing — scalar against AVX2, on a 10-leg basket (today's
+// UNDY) and a 64-leg one.
+//
+//   ./bench_basket
+
+#include <chrono>
+#include <iostream>
+#include <random>
+
+#include "basket_view.h"
+
+template <typename F>
+static double ns_per_call(F&& f) {
+    constexpr int CALLS = 2'000'000;
+    int64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < CALLS; ++i) sink += f();
+    auto t1 = std::chrono::steady_clock::now();
+    if (sink == 42) std::cout << "";
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / CALLS;
+}
+
+static void run(size_t legs) {
+    std::mt19937 rng(static_cast<uint32_t>(legs));
+    BasketView<64> v;
+    v.clear();
+    v.count = legs;
+    for (size_t i = 0; i < legs; ++i) {
+        v.bid_price[i] = 900 + static_cast<int32_t>(rng() % 200);
+        v.ask_price[i] = v.bid_price[i] + 1 + static_cast<int32_t>(rng() % 5);
+        v.bid_qty[i]   = static_cast<int32_t>(rng() % 50);
+        v.ask_qty[i]   = static_cast<int32_t>(rng() % 50);
+        v.position[i]  = static_cast<int32_t>(rng() % 11) - 5;
+        v.limit[i]     = 9;
+        v.weight[i]    = 1 + static_cast<int32_t>(rng() % 4);
+    }
+    size_t lanes = v.lanes();
+
+    auto sums_scalar = [&]() {
+        BasketSums s = basket_sums_scalar(v.weight.data(), v.bid_price.data(), v.ask_price.data(), lanes, legs);
+        return static_cast<int64_t>(s.nav_bid) + static_cast<int64_t>(s.ask_missing);
+    };
+    auto sums_avx2 = [&]() {
+        BasketSums s = basket_sums_avx2(v.weight.data(), v.bid_price.data(), v.ask_price.data(), lanes, legs);
+        return static_cast<int64_t>(s.nav_bid) + static_cast<int64_t>(s.ask_missing);
+    };
+    auto units_scalar = [&]() {
+        return static_cast<int64_t>(basket_max_units_scalar(v.ask_qty.data(), v.position.data(),
+                                                            v.limit.data(), v.weight.data(), +1, lanes));
+    };
+    auto units_avx2 = [&]() {
+        return static_cast<int64_t>(basket_max_units_avx2(v.ask_qty.data(), v.position.data(),
+                                                          v.limit.data(), v.weight.data(), +1, lanes));
+    };
+
+    std::cout << legs << " legs:\n"
+              << "  nav sums + masks   scalar " << ns_per_call(sums_scalar) << " ns";
+    if (basket_avx2_available()) std::cout << "   avx2 " << ns_per_call(sums_avx2) << " ns";
+    std::cout << "\n  min-units          scalar " << ns_per_call(units_scalar) << " ns";
+    if (basket_avx2_available()) std::cout << "   avx2 " << ns_per_call(units_avx2) << " ns";
+    std::cout << "\n";
+}
+
+int main() {
+    if (!basket_avx2_available())
+        std::cout << "(no AVX2 on this CPU: scalar kernels only)\n";
+    run(10);
+    run(64);
+    return 0;
+}
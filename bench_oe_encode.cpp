@@ -0,0 +1,156 @@
+// bench_oe_encode.cpp
+// Order encode and encode+send: the per-call build (zero the struct, fill
+// every header field) that OEClient used to do, against the prebuilt
+// OrderTemplates that patch seq_num, order_id, quantity and price.
+//
+//   ./bench_oe_encode
+//
+// encode:      build a NEW_ORDER rotating over the basket symbols and
+//              both sides — ns per order.
+// encode+send: the same, then send() over a TCP_NODELAY loopback socket
+//              to a thread that drains it — per-order latency, mean /
+//              p50 / p99. The syscall dominates; the gap is what the
+//              templates take off the hot path.
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "order_templates.h"
+
+static constexpr uint32_t CLIENT_ID  = 1;
+static constexpr uint64_t SESSION_ID = 77;
+
+// The per-call build, as the send paths did it before the templates
+struct PerCallEncoder {
+    ndfex::oe::new_order msg;
+
+    ndfex::oe::new_order& new_order(uint32_t seq, uint64_t order_id, uint32_t symbol,
+                                    SIDE side, uint32_t qty, int32_t price) {
+        msg = ndfex::oe::new_order{};
+        msg.header.length     = sizeof(msg);
+        msg.header.msg_type   = (uint8_t)ndfex::oe::MSG_TYPE::NEW_ORDER;
+        msg.header.version    = ndfex::oe::OE_PROTOCOL_VERSION;
+        msg.header.seq_num    = seq;
+        msg.header.client_id  = CLIENT_ID;
+        msg.header.session_id = SESSION_ID;
+        msg.order_id          = order_id;
+        msg.symbol            = symbol;
+        msg.side              = side;
+        msg.quantity          = qty;
+        msg.price             = price;
+        msg.flags             = 0;
+        return msg;
+    }
+};
+
+struct TemplateEncoder {
+    OrderTemplates t;
+    TemplateEncoder() { t.build(CLIENT_ID, SESSION_ID); }
+
+    ndfex::oe::new_order& new_order(uint32_t seq, uint64_t order_id, uint32_t symbol,
+                                    SIDE side, uint32_t qty, int32_t price) {
+        return t.new_order(seq, order_id, symbol, side, qty, price);
+    }
+};
+
+// Order i of the stream: the ten UNDY legs, alternating sides
+template <typename Enc>
+static ndfex::oe::new_order& order(Enc& enc, uint32_t i) {
+    return enc.new_order(i, 1000 + i, SYM_KNAN + i % 10,
+                         (i & 1) ? SIDE::SELL : SIDE::BUY, 1 + i % 5, 900 + static_cast<int32_t>(i % 64));
+}
+
+template <typename Enc>
+static double encode_ns() {
+    constexpr uint32_t CALLS = 10'000'000;
+    Enc enc;
+    uint64_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < CALLS; ++i) {
+        auto& m = order(enc, i);
+        sink += reinterpret_cast<const uint8_t*>(&m)[i % sizeof(m)];
+        asm volatile("" : : "r"(&m) : "memory");   // the send would read it
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    if (sink == 42) std::cout << "";
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / CALLS;
+}
+
+// Connected loopback pair; the server side is drained on a thread
+struct Loopback {
+    int client = -1, server = -1;
+    std::atomic<bool> stop{false};
+    std::thread       drain;
+
+    Loopback() {
+        int lfd = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(lfd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(lfd, 1);
+        socklen_t len = sizeof(addr);
+        getsockname(lfd, reinterpret_cast<sockaddr*>(&addr), &len);
+
+        client = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        connect(client, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        server = accept(lfd, nullptr, nullptr);
+        close(lfd);
+
+        drain = std::thread([this]() {
+            char buf[1 << 16];
+            while (recv(server, buf, sizeof(buf), 0) > 0) {}
+        });
+    }
+    ~Loopback() {
+        shutdown(client, SHUT_WR);
+        drain.join();
+        close(client);
+        close(server);
+    }
+};
+
+template <typename Enc>
+static void encode_send(const char* name) {
+    constexpr uint32_t SENDS = 200'000;
+    Loopback lb;
+    Enc enc;
+    std::vector<double> ns(SENDS);
+
+    for (uint32_t i = 0; i < SENDS; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        auto& m = order(enc, i);
+        send(lb.client, &m, sizeof(m), MSG_NOSIGNAL);
+        auto t1 = std::chrono::steady_clock::now();
+        ns[i] = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    }
+
+    double mean = 0;
+    for (double v : ns) mean += v;
+    mean /= SENDS;
+    std::sort(ns.begin(), ns.end());
+    std::cout << name << " encode+send mean " << mean << " ns"
+              << "  p50 " << ns[SENDS / 2] << " ns"
+              << "  p99 " << ns[SENDS * 99 / 100] << " ns\n";
+}
+
+int main() {
+    std::cout << "per-call build : encode " << encode_ns<PerCallEncoder>()  << " ns/order\n";
+    std::cout << "templates      : encode " << encode_ns<TemplateEncoder>() << " ns/order\n";
+    encode_send<PerCallEncoder> ("per-call build :");
+    encode_send<TemplateEncoder>("templates      :");
+    return 0;
+}
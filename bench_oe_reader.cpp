@@ -0,0 +1,121 @@
+// bench_oe_reader.cpp
+// Response read throughput: the two-recv read (header, then body) that
+// OEClient used to do per message, against OeFrameReader's buffered reads,
+// both draining an OeStubExchange that streams fills for one order.
+//
+//   ./bench_oe_reader [fills]        (default 2,000,000)
+//
+// Reports frames/s and recv() calls per frame for each reader. The stub
+// writes fills in large batches, so the buffered reader is limited by the
+// stream rather than by syscalls.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include "oe_frame_reader.h"
+#include "oe_stub_exchange.h"
+#include "order_templates.h"
+
+// The per-message read, as OEClient::read_response did it
+struct TwoRecvReader {
+    char     buf[256];
+    uint64_t recvs = 0;
+
+    const char* read(int fd, size_t& len) {
+        ndfex::oe::oe_response_header hdr;
+        size_t total = 0;
+        while (total < sizeof(hdr)) {
+            ssize_t n = recv(fd, (char*)&hdr + total, sizeof(hdr) - total, 0);
+            ++recvs;
+            if (n <= 0) return nullptr;
+            total += n;
+        }
+        memcpy(buf, &hdr, sizeof(hdr));
+        size_t remaining = hdr.length - sizeof(hdr);
+        total = 0;
+        while (total < remaining) {
+            ssize_t n = recv(fd, buf + sizeof(hdr) + total, remaining - total, 0);
+            ++recvs;
+            if (n <= 0) return nullptr;
+            total += n;
+        }
+        len = hdr.length;
+        return buf;
+    }
+};
+
+struct FramedReader {
+    OeFrameReader rx;
+    uint64_t      recvs = 0;
+
+    const char* read(int fd, size_t& len) {
+        while (true) {
+            if (const char* f = rx.next(len)) return f;
+            if (rx.malformed()) return nullptr;
+            ++recvs;
+            if (rx.fill(fd) <= 0) return nullptr;
+        }
+    }
+};
+
+// Log in, send one order, and read until its closing fill
+template <typename Reader>
+static void run(const char* name, uint32_t fills) {
+    OeStubExchange ex;
+    ex.fills_per_order = fills;
+    ex.start();
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = htons(static_cast<uint16_t>(ex.port()));
+    connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+
+    static Reader reader;
+    reader = Reader{};
+    size_t len;
+
+    ndfex::oe::login login{};
+    login.header.length   = sizeof(login);
+    login.header.msg_type = (uint8_t)ndfex::oe::MSG_TYPE::LOGIN;
+    login.header.version  = ndfex::oe::OE_PROTOCOL_VERSION;
+    send(fd, &login, sizeof(login), 0);
+    reader.read(fd, len);
+
+    OrderTemplates t;
+    t.build(1, OeStubExchange::SESSION_ID);
+    auto& order = t.new_order(2, 1, SYM_KNAN, SIDE::BUY, fills, 100);
+
+    auto t0 = std::chrono::steady_clock::now();
+    send(fd, &order, sizeof(order), 0);
+    uint64_t frames = 0;
+    bool     closed = false;
+    while (!closed) {
+        const char* f = reader.read(fd, len);
+        if (!f) break;
+        ++frames;
+        auto* hdr = reinterpret_cast<const ndfex::oe::oe_response_header*>(f);
+        if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::FILL)
+            closed = reinterpret_cast<const ndfex::oe::order_fill*>(f)->flags
+                  == (uint8_t)ndfex::oe::FILL_FLAGS::CLOSED;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double secs = std::chrono::duration<double>(t1 - t0).count();
+
+    std::cout << name << frames / secs / 1e6 << " M frames/s, "
+              << static_cast<double>(reader.recvs) / (frames ? frames : 1) << " recv/frame"
+              << (closed ? "" : "  (stream cut short)") << "\n";
+    close(fd);
+    ex.stop();
+}
+
+int main(int argc, char** argv) {
+    uint32_t fills = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 2'000'000;
+    std::cout << fills << " fills\n";
+    run<TwoRecvReader>("two recv per frame : ", fills);
+    run<FramedReader> ("buffered framing   : ", fills);
+    return 0;
+}
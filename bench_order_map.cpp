@@ -0,0 +1,174 @@
+// bench_order_map.cpp
+// Compares std::unordered_map against FlatHashMap as the order-id store,
+// driven by a market data message mix.
+//
+//   ./bench_order_map [capture.bin]
+//
+// capture.bin is raw md messages back to back, as they arrive on the wire
+// (each begins with an md_header carrying its length). Without a capture a
+// synthetic mix is generated: sequential ids, ~2k resting orders, and
+// 42% new / 42% delete / 10% modify / 6% trade.
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "messages.h"
+#include "orderbook.h"
+#include "flat_hash_map.h"
+
+struct Op {
+    MSG_TYPE type;
+    uint64_t order_id;
+    uint32_t quantity;
+    int32_t  price;
+    SIDE     side;
+};
+
+static std::vector<Op> load_capture(const char* path) {
+    std::vector<Op> ops;
+    std::ifstream f(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(f)),
+                            std::istreambuf_iterator<char>());
+    size_t off = 0;
+    while (off + sizeof(md_header) <= data.size()) {
+        auto* hdr = reinterpret_cast<const md_header*>(data.data() + off);
+        if (hdr->length < sizeof(md_header) || off + hdr->length > data.size()) break;
+        const char* p = data.data() + off;
+        switch (hdr->msg_type) {
+            case MSG_TYPE::NEW_ORDER: {
+                auto* m = reinterpret_cast<const new_order*>(p);
+                ops.push_back({hdr->msg_type, m->order_id, m->quantity, m->price, m->side});
+                break;
+            }
+            case MSG_TYPE::DELETE_ORDER: {
+                auto* m = reinterpret_cast<const delete_order*>(p);
+                ops.push_back({hdr->msg_type, m->order_id, 0, 0, SIDE::BUY});
+                break;
+            }
+            case MSG_TYPE::MODIFY_ORDER: {
+                auto* m = reinterpret_cast<const modify_order*>(p);
+                ops.push_back({hdr->msg_type, m->order_id, m->quantity, m->price, m->side});
+                break;
+            }
+            case MSG_TYPE::TRADE: {
+                auto* m = reinterpret_cast<const trade*>(p);
+                ops.push_back({hdr->msg_type, m->order_id, m->quantity, m->price, SIDE::BUY});
+                break;
+            }
+            default:
+                break;
+        }
+        off += hdr->length;
+    }
+    return ops;
+}
+
+static std::vector<Op> synthetic_mix(size_t n) {
+    std::vector<Op> ops;
+    ops.reserve(n);
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> live;
+    uint64_t next_id = 1;
+
+    while (ops.size() < n) {
+        unsigned r = rng() % 100;
+        if (r < 42 || live.size() < 2000) {
+            SIDE side = rng() % 2 ? SIDE::BUY : SIDE::SELL;
+            int32_t px = 1000 + static_cast<int32_t>(rng() % 40) * 5;
+            live.push_back(next_id);
+            ops.push_back({MSG_TYPE::NEW_ORDER, next_id++, 1 + uint32_t(rng() % 10), px, side});
+            continue;
+        }
+        size_t i     = rng() % live.size();
+        uint64_t oid = live[i];
+        if (r < 84) {
+            ops.push_back({MSG_TYPE::DELETE_ORDER, oid, 0, 0, SIDE::BUY});
+            live[i] = live.back();
+            live.pop_back();
+        } else if (r < 94) {
+            ops.push_back({MSG_TYPE::MODIFY_ORDER, oid, 1 + uint32_t(rng() % 10), 1000, SIDE::BUY});
+        } else {
+            ops.push_back({MSG_TYPE::TRADE, oid, 1, 0, SIDE::BUY});
+        }
+    }
+    return ops;
+}
+
+// ── Map adapters ──────────────────────────────────────────────────────────────
+
+struct StdMap {
+    std::unordered_map<uint64_t, OrderInfo> m;
+    StdMap() { m.reserve(10000); }
+    OrderInfo* find(uint64_t k) { auto it = m.find(k); return it == m.end() ? nullptr : &it->second; }
+    void insert(uint64_t k, const OrderInfo& v) { m[k] = v; }
+    void erase(uint64_t k) { m.erase(k); }
+};
+
+struct FlatMap {
+    FlatHashMap<OrderInfo> m{10000};
+    OrderInfo* find(uint64_t k) { return m.find(k); }
+    void insert(uint64_t k, const OrderInfo& v) { m.insert(k, v); }
+    void erase(uint64_t k) { m.erase(k); }
+};
+
+template <typename Map>
+static double run(const std::vector<Op>& ops, int rounds, uint64_t& checksum) {
+    double best = 1e18;
+    for (int r = 0; r < rounds; ++r) {
+        Map map;
+        auto t0 = std::chrono::steady_clock::now();
+        for (const Op& op : ops) {
+            switch (op.type) {
+                case MSG_TYPE::NEW_ORDER:
+                    map.insert(op.order_id, OrderInfo{op.price, op.quantity, op.side, 1});
+                    break;
+                case MSG_TYPE::DELETE_ORDER:
+                    if (map.find(op.order_id)) map.erase(op.order_id);
+                    break;
+                case MSG_TYPE::MODIFY_ORDER:
+                    if (OrderInfo* o = map.find(op.order_id)) {
+                        o->quantity = op.quantity;
+                        o->price    = op.price;
+                    }
+                    break;
+                case MSG_TYPE::TRADE:
+                    if (OrderInfo* o = map.find(op.order_id)) {
+                        if (o->quantity <= op.quantity) map.erase(op.order_id);
+                        else { o->quantity -= op.quantity; checksum += o->quantity; }
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (ns < best) best = ns;
+    }
+    return best / ops.size();
+}
+
+int main(int argc, char** argv) {
+    std::vector<Op> ops = argc > 1 ? load_capture(argv[1]) : synthetic_mix(2'000'000);
+    if (ops.empty()) {
+        std::cerr << "No messages to replay\n";
+        return 1;
+    }
+    std::cout << "Replaying " << ops.size() << " messages ("
+              << (argc > 1 ? argv[1] : "synthetic mix") << ")\n";
+
+    uint64_t sink = 0;
+    double std_ns  = run<StdMap >(ops, 5, sink);
+    double flat_ns = run<FlatMap>(ops, 5, sink);
+
+    std::cout << "std::unordered_map : " << std_ns  << " ns/msg\n";
+    std::cout << "FlatHashMap        : " << flat_ns << " ns/msg\n";
+    std::cout << "speedup            : " << std_ns / flat_ns << "x\n";
+    std::cout << "(checksum " << sink << ")\n";
+    return 0;
+}
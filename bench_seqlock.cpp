@@ -0,0 +1,125 @@
+// bench_seqlock.cpp
+// Compares the seqlocked TopOfBook record against the previous layout of
+// four independent atomics, between one writer (MD) and one reader
+// (strategy) thread.
+//
+//   ./bench_seqlock
+//
+// ping-pong:  the writer publishes update v and waits until the reader has
+//             seen it — round-trip latency of one publication.
+// free-run:   the writer publishes as fast as it can while the reader reads
+//             as fast as it can — reads/s and torn reads (fields from two
+//             different updates).
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "seqlock.h"
+#include "symbol_manager.h"
+
+// Spin-wait step. On a single CPU the other thread can only run if we
+// give up the core, so yield there (the numbers then measure the scheduler).
+static bool g_single_cpu = std::thread::hardware_concurrency() < 2;
+static void relax() {
+    if (g_single_cpu) std::this_thread::yield();
+}
+
+// Update v encodes itself in every field so a mixed read is detectable
+static TopOfBook make_tob(uint32_t v) {
+    return { static_cast<int32_t>(v), v, static_cast<int32_t>(v) + 1, v };
+}
+
+static bool torn(const TopOfBook& t) {
+    return t.bid_price != static_cast<int32_t>(t.bid_qty)
+        || t.ask_price != static_cast<int32_t>(t.bid_qty) + 1
+        || t.ask_qty   != t.bid_qty;
+}
+
+struct FourAtomics {
+    std::atomic<int32_t>  bid_price{0};
+    std::atomic<uint32_t> bid_qty{0};
+    std::atomic<int32_t>  ask_price{0};
+    std::atomic<uint32_t> ask_qty{0};
+
+    void store(const TopOfBook& t) {
+        bid_price.store(t.bid_price, std::memory_order_release);
+        bid_qty  .store(t.bid_qty,   std::memory_order_release);
+        ask_price.store(t.ask_price, std::memory_order_release);
+        ask_qty  .store(t.ask_qty,   std::memory_order_release);
+    }
+    TopOfBook load() const {
+        return { bid_price.load(std::memory_order_acquire),
+                 bid_qty  .load(std::memory_order_acquire),
+                 ask_price.load(std::memory_order_acquire),
+                 ask_qty  .load(std::memory_order_acquire) };
+    }
+};
+
+using SeqLocked = SeqLock<TopOfBook>;
+
+template <typename Cell>
+static double ping_pong(uint32_t rounds, uint64_t& torn_reads) {
+    alignas(64) Cell cell;
+    alignas(64) std::atomic<uint32_t> ack{0};
+    cell.store(make_tob(0));
+
+    std::thread reader([&]() {
+        for (uint32_t v = 1; v <= rounds; ++v) {
+            TopOfBook t;
+            while ((t = cell.load()).ask_qty != v) relax();
+            if (torn(t)) ++torn_reads;
+            ack.store(v, std::memory_order_release);
+        }
+    });
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t v = 1; v <= rounds; ++v) {
+        cell.store(make_tob(v));
+        while (ack.load(std::memory_order_acquire) != v) relax();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    reader.join();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / rounds;
+}
+
+template <typename Cell>
+static void free_run(std::chrono::milliseconds dur, uint64_t& reads, uint64_t& torn_reads) {
+    alignas(64) Cell cell;
+    std::atomic<bool> stop{false};
+    cell.store(make_tob(0));
+
+    std::thread reader([&]() {
+        while (!stop.load(std::memory_order_relaxed)) {
+            TopOfBook t = cell.load();
+            if (torn(t)) ++torn_reads;
+            ++reads;
+        }
+    });
+
+    auto end = std::chrono::steady_clock::now() + dur;
+    uint32_t v = 0;
+    while (std::chrono::steady_clock::now() < end)
+        for (int i = 0; i < 1024; ++i) cell.store(make_tob(++v));
+    stop.store(true);
+    reader.join();
+}
+
+template <typename Cell>
+static void report(const char* name) {
+    uint64_t pp_torn = 0, reads = 0, fr_torn = 0;
+    double rtt = ping_pong<Cell>(g_single_cpu ? 100'000 : 1'000'000, pp_torn);
+    free_run<Cell>(std::chrono::milliseconds(500), reads, fr_torn);
+    std::cout << name << " ping-pong " << rtt << " ns/round-trip"
+              << " | free-run " << reads * 2 / 1'000'000.0 << " M reads/s, "
+              << fr_torn << " torn (" << 100.0 * fr_torn / (reads ? reads : 1) << "%)\n";
+}
+
+int main() {
+    if (g_single_cpu)
+        std::cout << "(single CPU: threads time-share, numbers are not meaningful)\n";
+    report<FourAtomics>("four atomics :");
+    report<SeqLocked  >("seqlock      :");
+    return 0;
+}
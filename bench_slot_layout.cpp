@@ -0,0 +1,199 @@
+// bench_slot_layout.cpp
+// Cache misses taken by the strategy's 11-leg scan while the MD thread and
+// the fill thread write concurrently, for the previous SymbolSlot layout
+// (top of book, position and MD bookkeeping sharing per-symbol lines)
+// against the current one (state grouped by writer on separate lines).
+//
+//   ./bench_slot_layout
+//
+// The scanner counts its own L1D read misses and cache misses with
+// perf_event_open. Where perf counters are unavailable (containers, VMs,
+// perf_event_paranoid) it prints scan rate only.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "seqlock.h"
+#include "symbol_manager.h"
+
+static constexpr std::array<uint32_t, 11> LEGS = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 13};
+
+static bool g_single_cpu = std::thread::hardware_concurrency() < 3;
+
+// ── Layouts ───────────────────────────────────────────────────────────────────
+// Each exposes the three access patterns: md_update() (book work, then the
+// published record), fill() (position) and scan() (strategy read).
+
+// Before: one heap slot per symbol, everything for the symbol together
+struct OldLayout {
+    struct Slot {
+        uint64_t              book[8];     // stands in for book/anomaly state the MD thread writes
+        SeqLock<TopOfBook>    tob;
+        std::atomic<int32_t>  position{0};
+        std::atomic<bool>     stale{false};
+        TopOfBook             published{};
+    };
+    std::array<std::unique_ptr<Slot>, 14> slots;
+    std::atomic<double> total_pnl{0.0};
+
+    OldLayout() { for (uint32_t id = 1; id <= 13; ++id) slots[id] = std::make_unique<Slot>(); }
+
+    void md_update(uint32_t id, const TopOfBook& t) {
+        Slot& s = *slots[id];
+        ++s.book[0];
+        s.tob.store(t);
+        s.published = t;
+    }
+    void fill(uint32_t id) {
+        slots[id]->position.fetch_add(1, std::memory_order_release);
+        total_pnl.store(total_pnl.load(std::memory_order_relaxed) + 1.0, std::memory_order_relaxed);
+    }
+    int64_t scan() const {
+        int64_t sum = 0;
+        for (uint32_t id : LEGS) {
+            const Slot& s = *slots[id];
+            sum += s.tob.load().ask_price + s.position.load(std::memory_order_acquire);
+        }
+        return sum;
+    }
+};
+
+// After: mirrors SymbolManager's private layout
+struct NewLayout {
+    struct alignas(64) Slot {
+        uint64_t              book[8];
+        std::atomic<bool>     stale{false};
+        TopOfBook             published{};
+    };
+    alignas(64) std::atomic<uint32_t>  epoch_seq{0};
+    std::array<SeqLock<TopOfBook>, 14> tob;
+    alignas(64) std::array<std::atomic<int32_t>, 14> position{};
+    std::atomic<double>                total_pnl{0.0};
+    alignas(64) std::array<std::unique_ptr<Slot>, 14> slots;
+
+    NewLayout() { for (uint32_t id = 1; id <= 13; ++id) slots[id] = std::make_unique<Slot>(); }
+
+    void md_update(uint32_t id, const TopOfBook& t) {
+        Slot& s = *slots[id];
+        ++s.book[0];
+        tob[id].store(t);
+        s.published = t;
+    }
+    void fill(uint32_t id) {
+        position[id].fetch_add(1, std::memory_order_release);
+        total_pnl.store(total_pnl.load(std::memory_order_relaxed) + 1.0, std::memory_order_relaxed);
+    }
+    int64_t scan() const {
+        int64_t sum = 0;
+        for (uint32_t id : LEGS)
+            sum += tob[id].load().ask_price + position[id].load(std::memory_order_acquire);
+        return sum;
+    }
+};
+
+// ── perf counters ─────────────────────────────────────────────────────────────
+
+static int open_counter(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = type;
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    // Calling thread only, any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+struct Counters {
+    int l1d  = open_counter(PERF_TYPE_HW_CACHE,
+                            PERF_COUNT_HW_CACHE_L1D
+                          | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                          | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    int miss = open_counter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    ~Counters() { if (l1d >= 0) close(l1d); if (miss >= 0) close(miss); }
+
+    void start() {
+        for (int fd : {l1d, miss}) if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    static int64_t stop(int fd) {
+        if (fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t v = 0;
+        return read(fd, &v, sizeof(v)) == sizeof(v) ? static_cast<int64_t>(v) : -1;
+    }
+};
+
+// ── Run ───────────────────────────────────────────────────────────────────────
+
+template <typename Layout>
+static void run(const char* name, std::chrono::milliseconds dur) {
+    auto layout = std::make_unique<Layout>();
+    std::atomic<bool> stop{false};
+
+    std::thread md([&]() {
+        uint32_t v = 0, i = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            ++v;
+            layout->md_update(LEGS[i++ % LEGS.size()],
+                              { static_cast<int32_t>(v), v, static_cast<int32_t>(v) + 1, v });
+            if (g_single_cpu && (v & 255) == 0) std::this_thread::yield();
+        }
+    });
+    std::thread fills([&]() {
+        uint32_t i = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            layout->fill(LEGS[i++ % LEGS.size()]);
+            if (g_single_cpu && (i & 255) == 0) std::this_thread::yield();
+        }
+    });
+
+    uint64_t scans = 0;
+    int64_t  sink  = 0;
+    int64_t  l1d   = -1, miss = -1;
+    std::thread scanner([&]() {
+        Counters c;
+        c.start();
+        auto end = std::chrono::steady_clock::now() + dur;
+        while (std::chrono::steady_clock::now() < end) {
+            for (int i = 0; i < 256; ++i) sink += layout->scan();
+            scans += 256;
+        }
+        l1d  = Counters::stop(c.l1d);
+        miss = Counters::stop(c.miss);
+    });
+
+    scanner.join();
+    stop.store(true);
+    md.join();
+    fills.join();
+
+    double secs = std::chrono::duration<double>(dur).count();
+    std::cout << name << scans / secs / 1e6 << " M scans/s";
+    if (l1d >= 0)  std::cout << " | L1D read misses/scan " << static_cast<double>(l1d)  / scans;
+    if (miss >= 0) std::cout << " | cache misses/scan "    << static_cast<double>(miss) / scans;
+    if (l1d < 0 && miss < 0) std::cout << " | (perf counters unavailable)";
+    std::cout << (sink == 42 ? " " : "") << "\n";
+}
+
+int main() {
+    if (g_single_cpu)
+        std::cout << "(fewer than 3 CPUs: threads time-share, numbers are not meaningful)\n";
+    run<OldLayout>("per-symbol slots : ", std::chrono::milliseconds(1000));
+    run<NewLayout>("grouped by writer: ", std::chrono::milliseconds(1000));
+    return 0;
+}
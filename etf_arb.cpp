@@ -1,12 +1,20 @@
 #include "etf_arb.h"
 #include <iostream>
 #include <algorithm>
+#include <array>
 
 ETFArb::ETFArb(SymbolManager& sm, OEClient& oe, ETFClient& etf,
                std::atomic<bool>& shutdown, OrderMap& mm_order_map)
     : sm_(sm), oe_(oe), etf_(etf), global_shutdown_(shutdown),
+      etf_id_(sm.config().basket().etf_id),
+      blue_id_(sm.config().find("BLUE")),
       mm_order_map_(mm_order_map)
 {
+    for (const BasketLeg& leg : sm.config().basket().legs) {
+        leg_ids_.push_back(leg.symbol_id);
+        leg_weights_.push_back(leg.weight);
+    }
+
     oe_.set_on_fill([this](const FillEvent& f) {
         std::cout << "[FILL] order=" << f.order_id
                   << " qty=" << f.qty
@@ -44,13 +52,14 @@ void ETFArb::run() {
   std::cout << "[ETFArb] Starting arb loop\n";
 
     while (running_.load(std::memory_order_acquire)) {
+        oe_.dispatch_events();
 
         // ── Global PnL guard ──────────────────────────────────────────────
         if (sm_.pnl_near_limit()) {
             std::cerr << "[ETFArb] PnL near limit — unwinding and going dormant\n";
             oe_.cancel_all_open_orders();
 
-            for (uint32_t id = 1; id <= 13; ++id) {
+            for (uint32_t id : sm_.config().ids()) {
                 int32_t pos = sm_.get_position(id);
                 if (pos == 0) continue;
                 SIDE side     = pos > 0 ? SIDE::SELL : SIDE::BUY;
@@ -66,10 +75,11 @@ void ETFArb::run() {
             // Wait until flat then resume
             while (true) {
                 bool flat = true;
-                for (uint32_t id = 1; id <= 13; ++id)
+                for (uint32_t id : sm_.config().ids())
                     if (sm_.get_position(id) != 0) { flat = false; break; }
                 if (flat) break;
                 std::this_thread::sleep_for(std::chrono::seconds(1));
+                oe_.dispatch_events();   // fills arrive through the queue
             }
             std::cerr << "[ETFArb] Flat — resuming\n";
             continue;
@@ -78,9 +88,9 @@ void ETFArb::run() {
         // ── Wait for previous arb to complete ────────────────────────────
         if (arb_in_progress_.load(std::memory_order_acquire)) {
             bool all_flat = true;
-            for (uint32_t id : DORM_IDS)
+            for (uint32_t id : leg_ids_)
                 if (sm_.get_position(id) != 0) { all_flat = false; break; }
-            if (sm_.get_position(SYM_UNDY) != 0) all_flat = false;
+            if (sm_.get_position(etf_id_) != 0) all_flat = false;
 
             if (all_flat) {
                 arb_in_progress_.store(false, std::memory_order_release);
@@ -94,13 +104,13 @@ void ETFArb::run() {
                 std::cerr << "[ETFArb] Arb timeout — force unwinding\n";
                 unwind_dorm_longs();
 
-                int32_t undy_pos = sm_.get_position(SYM_UNDY);
+                int32_t undy_pos = sm_.get_position(etf_id_);
                 if (undy_pos > 0) {
-                    int32_t bid = sm_.best_bid_price(SYM_UNDY);
+                    int32_t bid = sm_.best_bid_price(etf_id_);
                     if (bid > 0) {
                         uint64_t oid = next_id();
-                        order_map_[oid] = {SYM_UNDY, SIDE::SELL};
-                        oe_.send_new_order(oid, SYM_UNDY, SIDE::SELL,
+                        order_map_[oid] = {etf_id_, SIDE::SELL};
+                        oe_.send_new_order(oid, etf_id_, SIDE::SELL,
                                            static_cast<uint32_t>(undy_pos), bid);
                     }
                 }
@@ -110,19 +120,20 @@ void ETFArb::run() {
         }
 
         // ── Arb opportunities ─────────────────────────────────────────────
-        ArbSnapshot snap = sm_.snapshot();
-
-        if (!try_creation_arb(snap))
-            try_redemption_arb(snap);
+        // The edges are kept current by the MD thread; only take a full
+        // snapshot when one of them is worth acting on.
+        ArbEdges edges = sm_.edges();
+        if (edges.creation > MIN_EDGE || edges.redemption > MIN_EDGE) {
+            ArbSnapshot snap = sm_.snapshot();
+            if (!try_creation_arb(snap))
+                try_redemption_arb(snap);
+        }
 
         // ── Debug ─────────────────────────────────────────────────────────
         static int tick = 0;
         if (++tick % 100000 == 0) {
-            std::cout << "[ARB] creation_edge="
-                      << (snap.undy_best_bid_price - snap.nav_ask)
-                      << " redemption_edge="
-                      << (snap.nav_bid - snap.undy_best_ask_price)
-                      << " missing_asks=" << snap.any_dorm_ask_missing
+            std::cout << "[ARB] creation_edge=" << edges.creation
+                      << " redemption_edge=" << edges.redemption
                       << " in_progress=" << arb_in_progress_.load()
                       << "\n";
         }
@@ -132,11 +143,11 @@ void ETFArb::run() {
 }
 
 bool ETFArb::try_creation_arb(const ArbSnapshot& snap) {
-    if (snap.any_dorm_ask_missing || snap.undy_best_bid_price == 0) return false;
+    // NO_EDGE (a leg has no price) is below any MIN_EDGE
+    if (snap.edges.creation <= MIN_EDGE) return false;
     if (arb_in_progress_.load(std::memory_order_acquire)) return false; 
 
-    int32_t edge = snap.undy_best_bid_price - snap.nav_ask;
-    if (edge <= MIN_EDGE) return false;
+    int32_t edge = snap.edges.creation;
 
     int32_t qty = creation_qty(snap);
     if (qty <= 0) return false;
@@ -145,34 +156,44 @@ bool ETFArb::try_creation_arb(const ArbSnapshot& snap) {
     arb_start_time_ = std::chrono::steady_clock::now();
 
     std::cout << "[ETFArb] CREATION arb: edge=" << edge
-              << " qty=" << qty << "\n";
-
-    // Step 1: fire all 10 dorm buys
-    std::array<uint64_t, 10> order_ids;
-    for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-        order_ids[i] = next_id();
-        order_map_[order_ids[i]] = {DORM_IDS[i], SIDE::BUY};
-        oe_.send_new_order_no_wait(order_ids[i], DORM_IDS[i],
-                                   SIDE::BUY, static_cast<uint32_t>(qty),
-                                   snap.dorms[i].best_ask_price);
+              << " qty=" << qty << " nav=" << snap.nav_ask
+              << " (cash " << snap.cash << ")\n";
+
+    // Step 1: fire every leg buy, as one burst
+    const size_t legs = leg_ids_.size();
+    std::array<OrderRequest, MAX_BASKET_LEGS> reqs;
+    std::array<OrderHandle, MAX_BASKET_LEGS>  handles;
+    for (size_t i = 0; i < legs; ++i) {
+        uint64_t oid = next_id();
+        order_map_[oid] = {leg_ids_[i], SIDE::BUY};
+        reqs[i] = OrderRequest{ oid, leg_ids_[i], SIDE::BUY,
+                                static_cast<uint32_t>(qty * leg_weights_[i]),
+                                snap.legs.ask_price[i] };
     }
-
-    // Step 2: collect ACKs
-    int acked = 0;
-    for (int i = 0; i < 10; ++i) {
-    if (oe_.wait_for_response(order_ids[i])) {
-        ++acked;
-        std::cout << "[ETFArb] Leg " << acked << "/10 ACK'd\n";
-    } else {
-        std::cerr << "[ETFArb] Leg " << (acked + 1) << "/10 REJECTED\n";
+    if (!oe_.submit_burst(reqs.data(), legs, handles.data()))
+        std::cerr << "[ETFArb] Send failed for creation legs — treating unsent as rejected\n";
+
+    // Step 2: collect ACKs, in whatever order they arrive
+    oe_.wait_all(handles.data(), legs, OrderWait::RESPONSE,
+                 std::chrono::steady_clock::now() + LEG_RESPONSE_TIMEOUT);
+    size_t acked = 0;
+    for (size_t i = 0; i < legs; ++i) {
+        if (leg_accepted(handles[i])) {
+            ++acked;
+            std::cout << "[ETFArb] Leg " << (i + 1) << "/" << legs << " ACK'd\n";
+        } else {
+            const OrderState* o = oe_.order_state(handles[i]);
+            std::cerr << "[ETFArb] Leg " << (i + 1) << "/" << legs
+                      << (o && o->responded() ? " REJECTED\n" : " unanswered\n");
+        }
+        oe_.release(handles[i]);
     }
-}
-if (acked < 10) {
-    std::cerr << "[ETFArb] Only " << acked << "/10 legs ACK'd — unwinding\n";
+if (acked < legs) {
+    std::cerr << "[ETFArb] Only " << acked << "/" << legs << " legs ACK'd — unwinding\n";
     unwind_dorm_longs();
     return true;
 }
-std::cout << "[ETFArb] All 10 legs ACK'd — polling for fills\n";
+std::cout << "[ETFArb] All " << legs << " legs ACK'd — polling for fills\n";
 
     // int filled = 0;
     // for (int i = 0; i < 10; ++i)
@@ -191,37 +212,39 @@ std::cout << "[ETFArb] All 10 legs ACK'd — polling for fills\n";
                   + std::chrono::milliseconds(5000);
     while (true) {
         bool all_filled = true;
-        for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-            int32_t pos = sm_.get_position(DORM_IDS[i]);
-            if (pos < qty) {
+        for (size_t i = 0; i < leg_ids_.size(); ++i) {
+            int32_t pos  = sm_.get_position(leg_ids_[i]);
+            int32_t need = qty * leg_weights_[i];
+            if (pos < need) {
                 all_filled = false;
                 // Print once per check so you can see which leg is slow
-                std::cout << "[ETFArb] Waiting on sym=" << DORM_IDS[i]
-                          << " pos=" << pos << " need=" << qty << "\n";
+                std::cout << "[ETFArb] Waiting on sym=" << leg_ids_[i]
+                          << " pos=" << pos << " need=" << need << "\n";
             }
         }
         if (all_filled) {
-            std::cout << "[ETFArb] All 10 dorm fills confirmed — proceeding to /create\n";
+            std::cout << "[ETFArb] All " << legs << " leg fills confirmed — proceeding to /create\n";
             break;
         }
         if (std::chrono::steady_clock::now() > deadline) {
             std::cerr << "[ETFArb] Dorm fill timeout after 2s — dumping positions:\n";
-            for (uint32_t id : DORM_IDS)
-                std::cerr << "  sym=" << id
-                          << " pos=" << sm_.get_position(id)
-                          << " need=" << qty << "\n";
+            for (size_t i = 0; i < legs; ++i)
+                std::cerr << "  sym=" << leg_ids_[i]
+                          << " pos=" << sm_.get_position(leg_ids_[i])
+                          << " need=" << qty * leg_weights_[i] << "\n";
             std::cerr << "[ETFArb] Unwinding partial fills\n";
             unwind_dorm_longs();
             arb_in_progress_.store(false, std::memory_order_release);
             return true;
         }
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        oe_.dispatch_events();
     }
 }
     // bool all_filled = true;
-    // for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-    //     if (sm_.get_position(DORM_IDS[i]) < qty) {
-    //         std::cerr << "[ETFArb] Pre-flight failed: sym=" << DORM_IDS[i] << "\n";
+    // for (size_t i = 0; i < leg_ids_.size(); ++i) {
+    //     if (sm_.get_position(leg_ids_[i]) < qty) {
+    //         std::cerr << "[ETFArb] Pre-flight failed: sym=" << leg_ids_[i] << "\n";
     //         all_filled = false;
     //     }
     // }
@@ -239,38 +262,41 @@ std::cout << "[ETFArb] All 10 legs ACK'd — polling for fills\n";
     }
 
     // Manually update SymbolManager — /create doesn't generate fills
-for (uint32_t id : DORM_IDS) {
-    sm_.on_fill(id, SIDE::SELL, static_cast<uint32_t>(qty),
+for (size_t i = 0; i < legs; ++i) {
+    uint32_t id = leg_ids_[i];
+    sm_.on_fill(id, SIDE::SELL, static_cast<uint32_t>(qty * leg_weights_[i]),
                 sm_.best_bid_price(id));  // use current bid as notional price
 }
-sm_.on_fill(SYM_UNDY, SIDE::BUY, static_cast<uint32_t>(qty),
+sm_.on_fill(etf_id_, SIDE::BUY, static_cast<uint32_t>(qty),
             snap.undy_best_bid_price);
 
     std::cout << "[ETFArb] /create OK, undy_balance=" << r.undy_balance << "\n";
 
     // Step 5: sell UNDY until flat
-    int32_t undy_pos = sm_.get_position(SYM_UNDY);
+    int32_t undy_pos = sm_.get_position(etf_id_);
     int32_t attempts = 0;
 
     while (undy_pos > 0 && attempts < 5) {
-        int32_t bid = sm_.best_bid_price(SYM_UNDY);
+        int32_t bid = sm_.best_bid_price(etf_id_);
         if (bid <= 0) {
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
-        undy_pos = sm_.get_position(SYM_UNDY);
+        oe_.dispatch_events();
+        undy_pos = sm_.get_position(etf_id_);
         continue;
         }
 
 
         uint64_t undy_oid = next_id();
-        order_map_[undy_oid] = {SYM_UNDY, SIDE::SELL};
-        oe_.send_new_order(undy_oid, SYM_UNDY,
+        order_map_[undy_oid] = {etf_id_, SIDE::SELL};
+        oe_.send_new_order(undy_oid, etf_id_,
                        SIDE::SELL, 
                        static_cast<uint32_t>(undy_pos),
                        bid); 
         
         // Wait briefly then check if position closed
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        undy_pos = sm_.get_position(SYM_UNDY);
+        oe_.dispatch_events();
+        undy_pos = sm_.get_position(etf_id_);
         ++attempts;
     }
 
@@ -283,11 +309,10 @@ sm_.on_fill(SYM_UNDY, SIDE::BUY, static_cast<uint32_t>(qty),
 }
 
 bool ETFArb::try_redemption_arb(const ArbSnapshot& snap) {
-    if (snap.any_dorm_bid_missing || snap.undy_best_ask_price == 0) return false;
+    if (snap.edges.redemption <= MIN_EDGE) return false;
     if (arb_in_progress_.load(std::memory_order_acquire)) return false; 
 
-    int32_t edge = snap.nav_bid - snap.undy_best_ask_price;
-    if (edge <= MIN_EDGE) return false;
+    int32_t edge = snap.edges.redemption;
 
     int32_t qty = redemption_qty(snap);
     if (qty <= 0) return false;
@@ -296,31 +321,46 @@ bool ETFArb::try_redemption_arb(const ArbSnapshot& snap) {
     arb_start_time_ = std::chrono::steady_clock::now();
 
     std::cout << "[ETFArb] REDEMPTION arb: edge=" << edge
-              << " qty=" << qty << "\n";
+              << " qty=" << qty << " nav=" << snap.nav_bid
+              << " (cash " << snap.cash << ")\n";
 
-    // Step 1: buy UNDY
+    // Step 1: buy UNDY, and only go on once the exchange has answered
     uint64_t undy_oid = next_id();
-    order_map_[undy_oid] = {SYM_UNDY, SIDE::BUY};
-    bool bought = oe_.send_new_order(undy_oid, SYM_UNDY,
-                                     SIDE::BUY, static_cast<uint32_t>(qty),
-                                     snap.undy_best_ask_price);
-    if (!bought) {
+    order_map_[undy_oid] = {etf_id_, SIDE::BUY};
+    OrderHandle undy = oe_.submit_new_order(undy_oid, etf_id_,
+                                            SIDE::BUY, static_cast<uint32_t>(qty),
+                                            snap.undy_best_ask_price);
+    oe_.wait_any(&undy, 1, OrderWait::RESPONSE,
+                 std::chrono::steady_clock::now() + LEG_RESPONSE_TIMEOUT);
+    const OrderState* o = oe_.order_state(undy);
+    if (!o || o->status == OrderStatus::REJECTED) {
         std::cerr << "[ETFArb] UNDY buy rejected\n";
+        oe_.release(undy);
         arb_in_progress_.store(false, std::memory_order_release);
         return false;
     }
+    if (!o->responded()) {
+        std::cerr << "[ETFArb] UNDY buy unanswered — aborting redemption\n";
+        oe_.release(undy);
+        arb_in_progress_.store(false, std::memory_order_release);
+        return true;
+    }
 
     std::cout << "[ETFArb] UNDY buy ACK'd — waiting for fill (need pos >= "
           << qty << ")\n";
-    
-          
-    if (!oe_.wait_for_fill(undy_oid)) {
+
+    oe_.wait_any(&undy, 1, OrderWait::DONE,
+                 std::chrono::steady_clock::now() + std::chrono::milliseconds(5000));
+    o = oe_.order_state(undy);
+    bool filled = o && o->status == OrderStatus::FILLED;
+    oe_.release(undy);
+    if (!filled) {
     std::cerr << "[ETFArb] UNDY fill failed/timeout — aborting redemption\n";
     arb_in_progress_.store(false, std::memory_order_release);
     return true;
     }
     std::cout << "[ETFArb] UNDY fill confirmed pos="
-          << sm_.get_position(SYM_UNDY) << " — proceeding to /redeem\n";  
+          << sm_.get_position(etf_id_) << " — proceeding to /redeem\n";  
 
     // Step 2: redeem
     ETFResult r = etf_.redeem(qty);
@@ -330,107 +370,111 @@ bool ETFArb::try_redemption_arb(const ArbSnapshot& snap) {
     }
 
     // Manually update SymbolManager — /redeem doesn't generate fills
-sm_.on_fill(SYM_UNDY, SIDE::SELL, static_cast<uint32_t>(qty),
+sm_.on_fill(etf_id_, SIDE::SELL, static_cast<uint32_t>(qty),
             snap.undy_best_ask_price);
-for (uint32_t id : DORM_IDS) {
-    sm_.on_fill(id, SIDE::BUY, static_cast<uint32_t>(qty),
+for (size_t i = 0; i < leg_ids_.size(); ++i) {
+    uint32_t id = leg_ids_[i];
+    sm_.on_fill(id, SIDE::BUY, static_cast<uint32_t>(qty * leg_weights_[i]),
                 sm_.best_ask_price(id));
 }
 
     std::cout << "[ETFArb] /redeem OK, undy_balance=" << r.undy_balance << "\n";
 
-    // Step 3: sell all 10 dorms
-    std::array<uint64_t, 10> order_ids;
-    for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-        order_ids[i] = next_id();
-        order_map_[order_ids[i]] = {DORM_IDS[i], SIDE::SELL};
-        oe_.send_new_order_no_wait(order_ids[i], DORM_IDS[i],
-                                   SIDE::SELL, static_cast<uint32_t>(qty),
-                                   snap.dorms[i].best_bid_price);
+    // Step 3: sell every leg, as one burst
+    std::array<OrderRequest, MAX_BASKET_LEGS> reqs;
+    std::array<OrderHandle, MAX_BASKET_LEGS>  handles;
+    for (size_t i = 0; i < leg_ids_.size(); ++i) {
+        uint64_t oid = next_id();
+        order_map_[oid] = {leg_ids_[i], SIDE::SELL};
+        reqs[i] = OrderRequest{ oid, leg_ids_[i], SIDE::SELL,
+                                static_cast<uint32_t>(qty * leg_weights_[i]),
+                                snap.legs.bid_price[i] };
     }
-    for (int i = 0; i < 10; ++i)
-        oe_.wait_for_response(order_ids[i]);
+    if (!oe_.submit_burst(reqs.data(), leg_ids_.size(), handles.data()))
+        std::cerr << "[ETFArb] Send failed for redemption legs — treating unsent as rejected\n";
+    oe_.wait_all(handles.data(), leg_ids_.size(), OrderWait::RESPONSE,
+                 std::chrono::steady_clock::now() + LEG_RESPONSE_TIMEOUT);
+    for (size_t i = 0; i < leg_ids_.size(); ++i)
+        oe_.release(handles[i]);
 
     return true;
 }
 
 void ETFArb::unwind_dorm_longs() {
-    std::array<uint64_t, 10> sent_ids;
-    std::array<uint32_t, 10> sent_syms;
+    std::array<OrderRequest, MAX_BASKET_LEGS> reqs{};
+    std::array<OrderHandle, MAX_BASKET_LEGS>  sent_ids;
+    std::array<uint32_t, MAX_BASKET_LEGS> sent_syms;
     int sent = 0;
-    for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-        int32_t pos = sm_.get_position(DORM_IDS[i]);
+    for (size_t i = 0; i < leg_ids_.size(); ++i) {
+        int32_t pos = sm_.get_position(leg_ids_[i]);
         //if (pos <= 0) continue;
         if (pos > 0) {
-            int32_t bid = sm_.best_bid_price(DORM_IDS[i]);
+            int32_t bid = sm_.best_bid_price(leg_ids_[i]);
             if (bid <= 0) {
             std::cerr << "[ETFArb] unwind_dorm_longs: no bid for sym="
-                      << DORM_IDS[i] << " pos=" << pos << " — skipping\n";
+                      << leg_ids_[i] << " pos=" << pos << " — skipping\n";
             continue;
             }
             uint64_t oid = next_id();
-            order_map_[oid] = {DORM_IDS[i], SIDE::SELL};
-            oe_.send_new_order_no_wait(oid, DORM_IDS[i],
-                                   SIDE::SELL,
-                                   static_cast<uint32_t>(pos), bid);
-            sent_ids[sent]  = oid;
-            sent_syms[sent] = DORM_IDS[i];
+            order_map_[oid] = {leg_ids_[i], SIDE::SELL};
+            reqs[sent]      = OrderRequest{ oid, leg_ids_[i], SIDE::SELL,
+                                            static_cast<uint32_t>(pos), bid };
+            sent_syms[sent] = leg_ids_[i];
             ++sent;
-            std::cout << "[ETFArb] unwind_dorm_longs: sent sell sym="
-                  << DORM_IDS[i] << " pos=" << pos
+            std::cout << "[ETFArb] unwind_dorm_longs: sell sym="
+                  << leg_ids_[i] << " pos=" << pos
                   << " @ " << bid << " order_id=" << oid << "\n";
         }
         else if (pos <= -8) {
-            int32_t ask = sm_.best_ask_price(DORM_IDS[i]);
+            int32_t ask = sm_.best_ask_price(leg_ids_[i]);
             if (ask <= 0) {
                 std::cerr << "[ETFArb] unwind_dorm_longs: no ask for sym="
-                          << DORM_IDS[i] << " pos=" << pos << " — skipping\n";
+                          << leg_ids_[i] << " pos=" << pos << " — skipping\n";
                 continue;
             }
-            std::cerr << "[ETFArb] unwind_dorm_longs: sym=" << DORM_IDS[i]
+            std::cerr << "[ETFArb] unwind_dorm_longs: sym=" << leg_ids_[i]
                       << " short pos=" << pos << " near limit — emergency cover\n";
             uint64_t oid = next_id();
-            order_map_[oid] = {DORM_IDS[i], SIDE::BUY};
-            oe_.send_new_order_no_wait(oid, DORM_IDS[i], SIDE::BUY,
-                                       static_cast<uint32_t>(std::abs(pos)), ask);
-            sent_ids[sent]  = oid;
-            sent_syms[sent] = DORM_IDS[i];
+            order_map_[oid] = {leg_ids_[i], SIDE::BUY};
+            reqs[sent]      = OrderRequest{ oid, leg_ids_[i], SIDE::BUY,
+                                            static_cast<uint32_t>(std::abs(pos)), ask };
+            sent_syms[sent] = leg_ids_[i];
             ++sent;
         }
     }
+    if (!oe_.submit_burst(reqs.data(), static_cast<size_t>(sent), sent_ids.data()))
+        std::cerr << "[ETFArb] Send failed for unwind orders — treating unsent as rejected\n";
+    oe_.wait_all(sent_ids.data(), static_cast<size_t>(sent), OrderWait::RESPONSE,
+                 std::chrono::steady_clock::now() + LEG_RESPONSE_TIMEOUT);
     for (int i = 0; i < sent; ++i) {
-        if(oe_.wait_for_response(sent_ids[i])){
+        if (leg_accepted(sent_ids[i])) {
              std::cout << "[ETFArb] unwind_dorm_longs: confirmed sym="
-                      << sent_syms[i] << " order_id=" << sent_ids[i] << "\n";
+                      << sent_syms[i] << " order_id=" << sent_ids[i].order_id << "\n";
         }
         else {
             std::cerr << "[ETFArb] unwind_dorm_longs: timeout/reject sym="
-                      << sent_syms[i] << " order_id=" << sent_ids[i] << "\n";
+                      << sent_syms[i] << " order_id=" << sent_ids[i].order_id << "\n";
         }
+        oe_.release(sent_ids[i]);
     }
     std::cout << "[ETFArb] unwind_dorm_longs: done sent=" << sent << "\n";
 }
 
+// ── Leg sizing ────────────────────────────────────────────────────────────────
+// Creation units every leg allows — min(lots on the book, room under our
+// limit) / weight — come from the snapshot's basket kernels; the ETF leg
+// is the one scalar term.
+
 int32_t ETFArb::creation_qty(const ArbSnapshot& snap) const {
-    int32_t qty = static_cast<int32_t>(snap.undy_best_bid_qty);
-    for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-        const auto& d = snap.dorms[i];
-        qty = std::min(qty, static_cast<int32_t>(d.best_ask_qty));
-        qty = std::min(qty, SymbolManager::POSITION_LIMIT - d.position);
-    }
-    qty = std::min(qty, SymbolManager::POSITION_LIMIT + snap.undy_position);
-    return qty;
+    int32_t qty = std::min(static_cast<int32_t>(snap.undy_best_bid_qty),
+                           sm_.position_limit(etf_id_) + snap.undy_position);
+    return std::min(qty, snap.legs.creation_units());
 }
 
 int32_t ETFArb::redemption_qty(const ArbSnapshot& snap) const {
-    int32_t qty = static_cast<int32_t>(snap.undy_best_ask_qty);
-    qty = std::min(qty, SymbolManager::POSITION_LIMIT - snap.undy_position);
-    for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-        const auto& d = snap.dorms[i];
-        qty = std::min(qty, static_cast<int32_t>(d.best_bid_qty));
-        qty = std::min(qty, SymbolManager::POSITION_LIMIT + d.position);
-    }
-    return qty;
+    int32_t qty = std::min(static_cast<int32_t>(snap.undy_best_ask_qty),
+                           sm_.position_limit(etf_id_) - snap.undy_position);
+    return std::min(qty, snap.legs.redemption_units());
 }
 
 void ETFArb::run_with_mm(int32_t mm_limit, uint32_t blue_tick) {
@@ -448,15 +492,34 @@ void ETFArb::run_with_mm(int32_t mm_limit, uint32_t blue_tick) {
         oid = 0;
     };
 
+    // Symbols whose book or position changed since the last pass
+    const uint32_t BLUE_BIT = blue_id_ ? 1u << blue_id_ : 0;
+    uint32_t BASKET_BIT     = 1u << etf_id_;
+    for (uint32_t id : leg_ids_) BASKET_BIT |= 1u << id;
+    uint32_t seen_seq   = sm_.change_seq();
+    uint32_t changed    = ~0u;     // first pass looks at everything
+    bool     blue_retry = false;   // requote skipped while an arb ran
+
     while (running_.load(std::memory_order_acquire)) {
 
+        // ── Wait for market data or a fill ────────────────────────────────
+        if (changed == 0) {
+            seen_seq = sm_.wait_for_change(seen_seq, wait_mode_, IDLE_WAKE);
+            changed  = sm_.take_changes();
+        }
+        // Order-entry responses queued by the reader thread; fills land in
+        // sm_ and show up as changes on the next pass
+        if (oe_.dispatch_events()) changed |= sm_.take_changes();
+        uint32_t todo = changed;
+        changed = 0;
+
         // ── PnL guard ─────────────────────────────────────────────────────
         if (sm_.pnl_near_limit()) {
             std::cerr << "[Bot] PnL near limit — unwinding\n";
             safe_delete(blue_bid_id_);
             safe_delete(blue_ask_id_);
             oe_.cancel_all_open_orders();
-            for (uint32_t id = 1; id <= 13; ++id) {
+            for (uint32_t id : sm_.config().ids()) {
                 int32_t pos = sm_.get_position(id);
                 if (pos == 0) continue;
                 SIDE side     = pos > 0 ? SIDE::SELL : SIDE::BUY;
@@ -470,10 +533,11 @@ void ETFArb::run_with_mm(int32_t mm_limit, uint32_t blue_tick) {
             }
             while (true) {
                 bool flat = true;
-                for (uint32_t id = 1; id <= 13; ++id)
+                for (uint32_t id : sm_.config().ids())
                     if (sm_.get_position(id) != 0) { flat = false; break; }
                 if (flat) break;
                 std::this_thread::sleep_for(std::chrono::seconds(1));
+                oe_.dispatch_events();   // fills arrive through the queue
             }
             std::cerr << "[Bot] Flat — resuming\n";
             continue;
@@ -482,13 +546,13 @@ void ETFArb::run_with_mm(int32_t mm_limit, uint32_t blue_tick) {
         // ── ETF arb ───────────────────────────────────────────────────────
         if (arb_in_progress_.load(std::memory_order_acquire)) {
             bool all_flat = true;
-            for (uint32_t id : DORM_IDS)
+            for (uint32_t id : leg_ids_)
                 if (sm_.get_position(id) > 0) { all_flat = false; break; }
-            if (sm_.get_position(SYM_UNDY) != 0) all_flat = false;
+            if (sm_.get_position(etf_id_) != 0) all_flat = false;
 
             if (all_flat) {
                 // Clean up residuals
-                for (uint32_t id : DORM_IDS) {
+                for (uint32_t id : leg_ids_) {
                     int32_t pos = sm_.get_position(id);
                     if (pos == 0) continue;
                     SIDE side     = pos > 0 ? SIDE::SELL : SIDE::BUY;
@@ -507,27 +571,34 @@ void ETFArb::run_with_mm(int32_t mm_limit, uint32_t blue_tick) {
                 if (elapsed > std::chrono::seconds(3)) {
                     std::cerr << "[Bot] Arb timeout — force unwinding\n";
                     unwind_dorm_longs();
-                    int32_t undy_pos = sm_.get_position(SYM_UNDY);
+                    int32_t undy_pos = sm_.get_position(etf_id_);
                     if (undy_pos > 0) {
-                        int32_t bid = sm_.best_bid_price(SYM_UNDY);
+                        int32_t bid = sm_.best_bid_price(etf_id_);
                         if (bid > 0) {
                             uint64_t oid = next_id();
-                            order_map_[oid] = {SYM_UNDY, SIDE::SELL};
-                            oe_.send_new_order(oid, SYM_UNDY, SIDE::SELL,
+                            order_map_[oid] = {etf_id_, SIDE::SELL};
+                            oe_.send_new_order(oid, etf_id_, SIDE::SELL,
                                                static_cast<uint32_t>(undy_pos), bid);
                         }
                     }
                     arb_in_progress_.store(false, std::memory_order_release);
                 }
             }
-        } else {
-            ArbSnapshot snap = sm_.snapshot();
-            if (!try_creation_arb(snap))
-                try_redemption_arb(snap);
+        } else if (todo & BASKET_BIT) {
+            ArbEdges edges = sm_.edges();
+            if (edges.creation > MIN_EDGE || edges.redemption > MIN_EDGE) {
+                ArbSnapshot snap = sm_.snapshot();
+                if (!try_creation_arb(snap))
+                    try_redemption_arb(snap);
+            }
         }
 
         // ── BLUE market maker ─────────────────────────────────────────────
-        int32_t blue_pos = sm_.get_position(SYM_BLUE);
+        if (!(todo & BLUE_BIT) && !(blue_retry && !arb_in_progress_.load()))
+            continue;
+        blue_retry = false;
+
+        int32_t blue_pos = sm_.get_position(blue_id_);
 
         // Position guards
         if (blue_pos >= mm_limit - 1 && blue_bid_id_ != 0) {
@@ -541,11 +612,11 @@ void ETFArb::run_with_mm(int32_t mm_limit, uint32_t blue_tick) {
 
 
         if (blue_pos < 0 && blue_flatten_id == 0) {
-            int32_t ask = sm_.best_ask_price(SYM_BLUE);
+            int32_t ask = sm_.best_ask_price(blue_id_);
             if (ask > 0) {
                 blue_flatten_id = ++mm_order_id;
-                mm_order_map_[blue_flatten_id] = {SYM_BLUE, SIDE::BUY};
-                oe_.send_new_order(blue_flatten_id, SYM_BLUE, SIDE::BUY,
+                mm_order_map_[blue_flatten_id] = {blue_id_, SIDE::BUY};
+                oe_.send_new_order(blue_flatten_id, blue_id_, SIDE::BUY,
                                    static_cast<uint32_t>(-blue_pos), ask);
                 std::cout << "[MM] Flatten BLUE short pos=" << blue_pos
                   << " order_id=" << blue_flatten_id << "\n";
@@ -553,29 +624,31 @@ void ETFArb::run_with_mm(int32_t mm_limit, uint32_t blue_tick) {
         }
         if (blue_pos >= 0) blue_flatten_id = 0; 
 
-        int32_t blue_bid = sm_.best_bid_price(SYM_BLUE);
-        int32_t blue_ask = sm_.best_ask_price(SYM_BLUE);
+        TopOfBook blue   = sm_.top_of_book(blue_id_);
+        int32_t blue_bid = blue.bid_price;
+        int32_t blue_ask = blue.ask_price;
 
         if (blue_bid > 0 && blue_ask > 0) {
             int32_t blue_mid = (blue_bid + blue_ask) / 2;
             blue_mid = (blue_mid / (int32_t)blue_tick) * (int32_t)blue_tick;
 
+            blue_retry = blue_mid != last_blue_mid && arb_in_progress_.load();
             if (blue_mid != last_blue_mid && !arb_in_progress_.load()) {
                 safe_delete(blue_bid_id_);
                 safe_delete(blue_ask_id_);
 
-                blue_pos = sm_.get_position(SYM_BLUE);
+                blue_pos = sm_.get_position(blue_id_);
                 if (blue_pos < mm_limit) {
                     blue_bid_id_ = ++mm_order_id;
-                    mm_order_map_[blue_bid_id_] = {SYM_BLUE, SIDE::BUY};
-                    oe_.send_new_order(blue_bid_id_, SYM_BLUE,
+                    mm_order_map_[blue_bid_id_] = {blue_id_, SIDE::BUY};
+                    oe_.send_new_order(blue_bid_id_, blue_id_,
                                       SIDE::BUY, 1, blue_mid - blue_tick);
                 }
-                blue_pos = sm_.get_position(SYM_BLUE);
+                blue_pos = sm_.get_position(blue_id_);
                 if (blue_pos > -mm_limit) {
                     blue_ask_id_ = ++mm_order_id;
-                    mm_order_map_[blue_ask_id_] = {SYM_BLUE, SIDE::SELL};
-                    oe_.send_new_order(blue_ask_id_, SYM_BLUE,
+                    mm_order_map_[blue_ask_id_] = {blue_id_, SIDE::SELL};
+                    oe_.send_new_order(blue_ask_id_, blue_id_,
                                       SIDE::SELL, 1, blue_mid + blue_tick);
                 }
                 last_blue_mid = blue_mid;
@@ -3,6 +3,7 @@
 #include <atomic>
 #include <cstdint>
 #include <unordered_map>
+#include <vector>
 #include <utility>
 #include <thread>
 #include <chrono>
@@ -13,6 +14,13 @@
 
 static constexpr int32_t MIN_EDGE = 0;
 
+// Longest run_with_mm sleeps without a market data change or fill, so the
+// arb timeout and PnL guard are still checked on a quiet feed
+static constexpr std::chrono::microseconds IDLE_WAKE{1000};
+
+// How long a pipelined multi-leg send waits for every leg's first response
+static constexpr std::chrono::milliseconds LEG_RESPONSE_TIMEOUT{3000};
+
 using OrderMap = std::unordered_map<uint64_t, std::pair<uint32_t, SIDE>>;
 
 
@@ -25,6 +33,10 @@ public:
     void run();
     void stop() { running_.store(false, std::memory_order_release); }
     void run_with_mm(int32_t mm_limit, uint32_t blue_tick);
+
+    // BUSY_POLL for a pinned core; SPIN_THEN_PARK (default) to sleep
+    // between updates. Set before run_with_mm().
+    void set_wait_mode(WaitMode mode) { wait_mode_ = mode; }
     std::atomic<bool> arb_in_progress_{false};
 
 private:
@@ -32,12 +44,20 @@ private:
     OEClient&          oe_;
     ETFClient&         etf_;
     std::atomic<bool>& global_shutdown_;
+
+    // Basket and market-making symbols, from sm_.config()
+    uint32_t              etf_id_;
+    uint32_t              blue_id_;       // 0 if BLUE is not configured
+    std::vector<uint32_t> leg_ids_;
+    std::vector<int32_t>  leg_weights_;   // lots per creation unit
+
     std::atomic<bool>  running_{true};
     std::atomic<uint64_t> next_order_id_{1000};
     std::chrono::steady_clock::time_point arb_start_time_;
     std::chrono::steady_clock::time_point last_unwind_time_{};
     uint64_t blue_bid_id_  = 0;
     uint64_t blue_ask_id_  = 0;
+    WaitMode wait_mode_    = WaitMode::SPIN_THEN_PARK;
 
     std::unordered_map<uint64_t, std::pair<uint32_t, SIDE>> order_map_;
     OrderMap& mm_order_map_; 
@@ -51,4 +71,10 @@ private:
     int32_t creation_qty       (const ArbSnapshot& snap) const;
     int32_t redemption_qty     (const ArbSnapshot& snap) const;
     void    unwind_dorm_longs  ();
+
+    // ACK'd or already filled — anything but rejected or still unanswered
+    bool leg_accepted(OrderHandle h) const {
+        const OrderState* o = oe_.order_state(h);
+        return o && o->responded() && o->status != OrderStatus::REJECTED;
+    }
 };
\ No newline at end of file
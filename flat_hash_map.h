@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ── FlatHashMap ───────────────────────────────────────────────────────────────
+//
+// Open-addressing hash map specialised for 64-bit exchange order ids.
+//
+//   - Slots live in one flat array: a lookup is a multiply, a shift and a
+//     short linear scan, with no node allocation and no pointer chase.
+//   - Robin Hood probing: an entry far from its home slot displaces one
+//     closer to home, which keeps probe lengths short and lets a miss stop
+//     as soon as it meets an entry nearer its home than the probe is.
+//   - Deletion shifts the following cluster back one slot (backward-shift),
+//     so there are no tombstones and no rehash-to-clean.
+//   - Fibonacci hashing on the id spreads the sequential ids exchanges hand
+//     out across the table.
+//
+// Pointers returned by find()/insert() are invalidated by any later insert
+// or erase — entries move. Read what you need before mutating the map.
+
+template <typename V>
+class FlatHashMap {
+public:
+    explicit FlatHashMap(size_t expected = 16) { reserve(expected); }
+
+    size_t size()     const { return size_; }
+    bool   empty()    const { return size_ == 0; }
+    size_t capacity() const { return slots_.size(); }
+
+    // Grow so `n` entries fit under the load limit. Never shrinks.
+    void reserve(size_t n) {
+        size_t cap = 16;
+        while (cap * MAX_LOAD_NUM < n * MAX_LOAD_DEN) cap <<= 1;
+        if (cap > slots_.size()) rehash(cap);
+    }
+
+    // Drop every entry but keep the table allocated
+    void clear() {
+        for (auto& s : slots_) s.dist = 0;
+        size_ = 0;
+    }
+
+    V* find(uint64_t key) {
+        size_t   idx  = home(key);
+        uint32_t dist = 1;
+        while (true) {
+            Slot& s = slots_[idx];
+            if (s.dist < dist) return nullptr;     // empty, or would have been placed here
+            if (s.key == key)  return &s.value;
+            idx = (idx + 1) & mask_;
+            ++dist;
+        }
+    }
+
+    const V* find(uint64_t key) const {
+        return const_cast<FlatHashMap*>(this)->find(key);
+    }
+
+    bool contains(uint64_t key) const { return find(key) != nullptr; }
+
+    // Insert or overwrite. Returns a pointer to the stored value.
+    V* insert(uint64_t key, V value) {
+        if (V* v = find(key)) {
+            *v = std::move(value);
+            return v;
+        }
+        if ((size_ + 1) * MAX_LOAD_DEN > slots_.size() * MAX_LOAD_NUM)
+            rehash(slots_.size() * 2);
+        return place(key, std::move(value));
+    }
+
+    // Value for `key`, default-constructed if absent
+    V& operator[](uint64_t key) {
+        if (V* v = find(key)) return *v;
+        return *insert(key, V{});
+    }
+
+    bool erase(uint64_t key) {
+        size_t   idx  = home(key);
+        uint32_t dist = 1;
+        while (true) {
+            Slot& s = slots_[idx];
+            if (s.dist < dist) return false;
+            if (s.key == key)  break;
+            idx = (idx + 1) & mask_;
+            ++dist;
+        }
+
+        // Backward-shift the rest of the cluster into the hole
+        size_t next = (idx + 1) & mask_;
+        while (slots_[next].dist > 1) {
+            slots_[idx] = std::move(slots_[next]);
+            --slots_[idx].dist;
+            idx  = next;
+            next = (next + 1) & mask_;
+        }
+        slots_[idx].dist = 0;
+        --size_;
+        return true;
+    }
+
+    // Visit every entry: f(uint64_t key, V& value). Must not mutate the map.
+    template <typename F>
+    void for_each(F&& f) {
+        for (auto& s : slots_)
+            if (s.dist) f(s.key, s.value);
+    }
+
+private:
+    // Max load 7/8 — Robin Hood keeps probes short well past what linear
+    // probing tolerates.
+    static constexpr size_t MAX_LOAD_NUM = 7;
+    static constexpr size_t MAX_LOAD_DEN = 8;
+
+    struct Slot {
+        uint64_t key  = 0;
+        uint32_t dist = 0;   // 1 + distance from home slot; 0 = empty
+        V        value{};
+    };
+
+    std::vector<Slot> slots_;
+    size_t            mask_  = 0;
+    unsigned          shift_ = 64;
+    size_t            size_  = 0;
+
+    size_t home(uint64_t key) const {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    // Robin Hood placement of a key known to be absent
+    V* place(uint64_t key, V value) {
+        Slot     cur{key, 1, std::move(value)};
+        size_t   idx    = home(key);
+        V*       result = nullptr;
+        while (true) {
+            Slot& s = slots_[idx];
+            if (s.dist == 0) {
+                s = std::move(cur);
+                ++size_;
+                return result ? result : &s.value;
+            }
+            if (s.dist < cur.dist) {
+                std::swap(s, cur);
+                if (!result) result = &s.value;
+            }
+            idx = (idx + 1) & mask_;
+            ++cur.dist;
+        }
+    }
+
+    void rehash(size_t new_cap) {
+        std::vector<Slot> old(new_cap);
+        old.swap(slots_);
+        mask_  = new_cap - 1;
+        shift_ = 64 - __builtin_ctzll(new_cap);
+        size_  = 0;
+        for (auto& s : old)
+            if (s.dist) place(s.key, std::move(s.value));
+    }
+};
@@ -1,28 +1,144 @@
 #include "listener.h"
+#include "packet_ring.h"
 
 #include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <sys/epoll.h>
+#include <sys/uio.h>
 #include <fcntl.h>
 #include <cstring>
 #include <iostream>
-#include <queue>
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 int create_multicast_socket(const char* mcast_addr, int port, const char* local_ip);
 
-struct BufferedMessage {
-    char   data[1500];
-    size_t length;
+static constexpr size_t   PACKET_SIZE = 1500;
+static constexpr unsigned RECV_BATCH  = 64;
+
+// Virtual size of the pending-live ring. Pages are committed on first
+// write and released when the ring is cleared after a catch-up, so only
+// the largest single backlog ever costs memory.
+static constexpr size_t   PENDING_RING_BYTES = size_t(1) << 30;
+
+// ── Batched receive ───────────────────────────────────────────────────────────
+// One recvmmsg() pulls up to RECV_BATCH datagrams into a preallocated packet
+// array, so a burst costs one syscall instead of one read() per packet.
+// hist[n] counts the receives that returned exactly n packets — if the top
+// bucket is busy the batch is too small, if it never fills it is too large.
+
+struct RecvBatch {
+    alignas(64) char data[RECV_BATCH][PACKET_SIZE];
+    iovec    iov [RECV_BATCH];
+    mmsghdr  msgs[RECV_BATCH];
+    uint64_t hist[RECV_BATCH + 1] = {};
+
+    RecvBatch() {
+        memset(msgs, 0, sizeof(msgs));
+        for (unsigned i = 0; i < RECV_BATCH; ++i) {
+            iov[i].iov_base            = data[i];
+            iov[i].iov_len             = PACKET_SIZE;
+            msgs[i].msg_hdr.msg_iov    = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    // Returns the number of packets received, 0 if the socket is drained.
+    int receive(int fd) {
+        int n = recvmmsg(fd, msgs, RECV_BATCH, MSG_DONTWAIT, nullptr);
+        if (n <= 0) return 0;
+        ++hist[n];
+        return n;
+    }
+
+    size_t length(int i) const { return msgs[i].msg_len; }
+
+    void print_stats() const {
+        uint64_t batches = 0, packets = 0;
+        unsigned max_n   = 0;
+        for (unsigned n = 1; n <= RECV_BATCH; ++n) {
+            batches += hist[n];
+            packets += hist[n] * n;
+            if (hist[n]) max_n = n;
+        }
+        if (batches == 0) return;
+        std::cout << "[Listener] recv batches=" << batches
+                  << " avg=" << static_cast<double>(packets) / batches
+                  << " max=" << max_n
+                  << " full=" << hist[RECV_BATCH] << "\n";
+    }
 };
 
+// ── Message dispatch ──────────────────────────────────────────────────────────
+
+uint32_t route_md_message(const SymbolManager& sm, const OrderRouter& router, const md_header* hdr) {
+    uint64_t order_id;
+    switch (hdr->msg_type) {
+        case MSG_TYPE::NEW_ORDER: {
+            uint32_t symbol = reinterpret_cast<const new_order*>(hdr)->symbol;
+            return sm.has_symbol(symbol) ? symbol : 0;
+        }
+        case MSG_TYPE::DELETE_ORDER:
+            order_id = reinterpret_cast<const delete_order*>(hdr)->order_id;
+            break;
+        case MSG_TYPE::MODIFY_ORDER:
+            order_id = reinterpret_cast<const modify_order*>(hdr)->order_id;
+            break;
+        case MSG_TYPE::TRADE:
+            order_id = reinterpret_cast<const trade*>(hdr)->order_id;
+            break;
+        default:
+            return 0;
+    }
+    return router.find(order_id);
+}
+
+void apply_md_message(SymbolManager& sm, OrderRouter& router, uint32_t symbol, char* buf) {
+    md_header* hdr = reinterpret_cast<md_header*>(buf);
+    switch (hdr->msg_type) {
+        case MSG_TYPE::NEW_ORDER: {
+            auto* msg = reinterpret_cast<new_order*>(buf);
+            if (sm.on_new_order(msg->symbol, msg))
+                router.add(msg->order_id, msg->symbol);
+            break;
+        }
+        case MSG_TYPE::DELETE_ORDER: {
+            auto* msg = reinterpret_cast<delete_order*>(buf);
+            sm.on_delete_order(symbol, msg);
+            router.erase(msg->order_id);
+            break;
+        }
+        case MSG_TYPE::MODIFY_ORDER:
+            sm.on_modify_order(symbol, reinterpret_cast<modify_order*>(buf));
+            break;
+        case MSG_TYPE::TRADE: {
+            auto* msg = reinterpret_cast<trade*>(buf);
+            if (!sm.on_trade(symbol, msg))
+                router.erase(msg->order_id);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
 void run_listener(SymbolManager& sm) {
     // order_id → symbol_id routing for delete/modify/trade messages
-    std::unordered_map<uint64_t, uint32_t> order_to_symbol;
+    OrderRouter router;
 
-    std::queue<BufferedMessage> live_buffer;
+    // Orders of the snapshot being loaded, handed to the book as one batch
+    std::vector<const new_order*> snapshot_orders;
+    snapshot_orders.reserve(4096);
+
+    // Live messages received while any symbol is stale. Replayed per symbol
+    // once that symbol's snapshot arrives, then dropped when all are clean.
+    PacketRing recovery_buffer(PENDING_RING_BYTES);
+    if (!recovery_buffer.valid()) {
+        std::cerr << "[Listener] Failed to map pending-live ring\n";
+        return;
+    }
 
     const char* live_addr   = "239.0.0.1";
     const int   live_port   = 12345;
@@ -46,180 +162,201 @@ void run_listener(SymbolManager& sm) {
     ev.data.fd = live_sock;
     epoll_ctl(epoll_fd, EPOLL_CTL_ADD, live_sock, &ev);
 
-    char     buf[1500];
-    bool     caught_up        = false;
-    bool     received_snapshot = false;
+    // ~100KB of packet buffers — keep it off the thread stack
+    auto     batch = std::make_unique<RecvBatch>();
     uint32_t messages_processed = 0;
-    int      no_replay_count  = 0;
+    uint64_t feed_ts            = 0;   // timestamp of the last live message
+
+    // Sequence tracking on the live feed. seq_num is feed-wide, so a gap
+    // cannot be pinned on one symbol: every book goes stale and each one
+    // recovers independently from its next snapshot at or past resync_seq.
+    // Startup is the same as a gap before the first message — every book
+    // starts stale and goes live as soon as its own snapshot is aligned.
+    uint32_t last_live_seq = 0;
+    uint32_t resync_seq    = 0;
+    uint32_t stale_count   = 0;
+
+    for (uint32_t id : sm.config().ids()) {
+        sm.mark_stale(id);
+        ++stale_count;
+    }
 
     // ── Inline helpers ────────────────────────────────────────────────────────
 
-    // Route a new_order into SymbolManager and record order→symbol mapping
-    auto dispatch_new_order = [&](new_order* msg) {
-        sm.on_new_order(msg->symbol, msg);
-        order_to_symbol[msg->order_id] = msg->symbol;
-    };
+    auto route = [&](const md_header* hdr) { return route_md_message(sm, router, hdr); };
+    auto apply = [&](uint32_t symbol, char* buf) { apply_md_message(sm, router, symbol, buf); };
 
-    auto dispatch_delete_order = [&](delete_order* msg) {
-        auto it = order_to_symbol.find(msg->order_id);
-        if (it == order_to_symbol.end()) return;
-        sm.on_delete_order(it->second, msg);
-        order_to_symbol.erase(it);
+    // Check the live feed for dropped packets
+    auto check_sequence = [&](uint32_t seq) {
+        if (last_live_seq == 0) {
+            // Joined mid-stream: anything before this message was missed
+            resync_seq    = seq - 1;
+            last_live_seq = seq;
+            return;
+        }
+        if (seq > last_live_seq + 1) {
+            std::cerr << "[Listener] Sequence gap: expected " << last_live_seq + 1
+                      << " got " << seq << " — resyncing all books\n";
+            resync_seq  = seq - 1;
+            stale_count = 0;
+            for (uint32_t id : sm.config().ids()) {
+                sm.mark_stale(id);
+                ++stale_count;
+            }
+        }
+        if (seq > last_live_seq) last_live_seq = seq;
     };
 
-    auto dispatch_modify_order = [&](modify_order* msg) {
-        auto it = order_to_symbol.find(msg->order_id);
-        if (it == order_to_symbol.end()) return;
-        sm.on_modify_order(it->second, msg);
-    };
+    // Apply one market data message, skipping stale books and anything the
+    // book has already seen (via snapshot or replay). Only the live feed is
+    // buffered for catch-up: the replay socket repeats live messages, and
+    // buffering both would queue the same update twice.
+    auto on_live_message = [&](char* buf, size_t len, bool live) {
+        md_header* hdr = reinterpret_cast<md_header*>(buf);
+
+        if (live && stale_count > 0) {
+            // Full ring: drop the oldest messages. A snapshot must now reach
+            // past them, so raise resync_seq instead of giving up.
+            while (!recovery_buffer.push(buf, static_cast<uint32_t>(len))) {
+                uint32_t old_len;
+                auto* old = reinterpret_cast<md_header*>(recovery_buffer.front(old_len));
+                if (old->seq_num > resync_seq) resync_seq = old->seq_num;
+                recovery_buffer.pop();
+            }
+        }
 
-    auto dispatch_trade = [&](trade* msg) {
-        auto it = order_to_symbol.find(msg->order_id);
-        if (it == order_to_symbol.end()) return;
-        sm.on_trade(it->second, msg);
+        uint32_t symbol = route(hdr);
+        if (symbol == 0 || sm.is_stale(symbol)) return;
+        if (hdr->seq_num <= sm.last_seq_num(symbol)) return;
+        apply(symbol, buf);
     };
 
-    std::cout << "[Listener] Starting market data feed...\n";
-
-    while (true) {
-        epoll_event events[16];
-        int timeout = caught_up ? -1 : 10;
-        int nfds    = epoll_wait(epoll_fd, events, 16, timeout);
-
-        if (nfds < 0) {
-            std::cerr << "[Listener] epoll_wait failed: " << strerror(errno) << "\n";
-            return;
+    // Rebuild a stale book: replay every buffered message for `symbol`
+    // newer than its snapshot and than anything the book already applied,
+    // then republish it.
+    auto recover_symbol = [&](uint32_t symbol, uint32_t snap_seq) {
+        uint32_t replayed = 0;
+        recovery_buffer.for_each([&](char* data, uint32_t) {
+            md_header* hdr = reinterpret_cast<md_header*>(data);
+            if (hdr->seq_num <= snap_seq) return;
+            if (route(hdr) != symbol) return;
+            if (hdr->seq_num <= sm.last_seq_num(symbol)) return;
+            apply(symbol, data);
+            ++replayed;
+        });
+        sm.clear_stale(symbol);
+        std::cout << "[Listener] Recovered symbol=" << symbol
+                  << " snapshot_seq=" << snap_seq
+                  << " replayed=" << replayed << "\n";
+
+        if (--stale_count == 0) {
+            recovery_buffer.clear();
+            std::cout << "[Listener] All books aligned — on live feed\n";
         }
+    };
 
-        // ── Catch-up: switch to live feed once replay goes quiet ─────────────
-        if (nfds == 0 && !caught_up && received_snapshot) {
-            if (++no_replay_count > 100) {
-                std::cout << "[Listener] Caught up — draining "
-                          << live_buffer.size() << " buffered messages\n";
-                caught_up = true;
-
-                while (!live_buffer.empty()) {
-                    BufferedMessage& bm = live_buffer.front();
-                    memcpy(buf, bm.data, bm.length);
-
-                    md_header* hdr = reinterpret_cast<md_header*>(buf);
-                    if (hdr->magic_number == MAGIC_NUMBER) {
-                        switch (hdr->msg_type) {
-                            case MSG_TYPE::NEW_ORDER:
-                                dispatch_new_order(reinterpret_cast<new_order*>(buf));
-                                break;
-                            case MSG_TYPE::DELETE_ORDER:
-                                dispatch_delete_order(reinterpret_cast<delete_order*>(buf));
-                                break;
-                            case MSG_TYPE::MODIFY_ORDER:
-                                dispatch_modify_order(reinterpret_cast<modify_order*>(buf));
-                                break;
-                            case MSG_TYPE::TRADE:
-                                dispatch_trade(reinterpret_cast<trade*>(buf));
-                                break;
-                            default:
-                                break;
-                        }
-                    }
-                    live_buffer.pop();
-                }
-
-                std::cout << "[Listener] Now on live feed.\n";
-            }
-            continue;
-        }
+    // Handle one datagram
+    auto handle_packet = [&](int fd, char* buf, ssize_t bytes) {
+        md_header* hdr = reinterpret_cast<md_header*>(buf);
 
-        // ── Process incoming packets ──────────────────────────────────────────
-        for (int i = 0; i < nfds; ++i) {
-            ssize_t bytes = read(events[i].data.fd, buf, sizeof(buf));
-            if (bytes <= 0) continue;
-
-            // Buffer live messages until we've caught up with replay
-            if (!caught_up && events[i].data.fd == live_sock) {
-                if (live_buffer.size() > 100000) {
-                    std::cerr << "[Listener] FATAL: live buffer overflow\n";
-                    return;
-                }
-                BufferedMessage bm;
-                memcpy(bm.data, buf, bytes);
-                bm.length = bytes;
-                live_buffer.push(bm);
-                continue;
-            }
+        if (fd == live_sock && hdr->magic_number == MAGIC_NUMBER)
+            check_sequence(hdr->seq_num);
 
-            md_header* hdr = reinterpret_cast<md_header*>(buf);
+        // ── Snapshot ──────────────────────────────────────────────────────────
+        if (hdr->magic_number == SNAPSHOT_MAGIC_NUMBER) {
+            ssize_t offset = 0;
+            while (offset < bytes) {
+                md_header* shdr = reinterpret_cast<md_header*>(buf + offset);
+                if (shdr->msg_type != MSG_TYPE::SNAPSHOT_INFO) break;
 
-            // ── Snapshot ──────────────────────────────────────────────────────
-            if (hdr->magic_number == SNAPSHOT_MAGIC_NUMBER) {
-                ssize_t offset = 0;
-                while (offset < bytes) {
-                    md_header* shdr = reinterpret_cast<md_header*>(buf + offset);
-                    if (shdr->msg_type != MSG_TYPE::SNAPSHOT_INFO) break;
+                snapshot_info* snap = reinterpret_cast<snapshot_info*>(buf + offset);
+                uint32_t symbol     = snap->symbol;
 
-                    snapshot_info* snap = reinterpret_cast<snapshot_info*>(buf + offset);
-                    uint32_t symbol     = snap->symbol;
+                // Only a stale book loads a snapshot, and only one that
+                // reaches the live messages we hold — taken after the gap,
+                // or after the first live message at startup. Live books
+                // are ahead of any snapshot.
+                bool load = sm.has_symbol(symbol) && sm.is_stale(symbol)
+                         && last_live_seq != 0
+                         && snap->last_md_seq_num >= resync_seq;
 
+                if (load) {
                     sm.reset_book(symbol);
 
                     // Remove stale order→symbol mappings for this symbol
-                    for (auto it = order_to_symbol.begin(); it != order_to_symbol.end(); ) {
-                        if (it->second == symbol) it = order_to_symbol.erase(it);
-                        else ++it;
-                    }
+                    router.drop_symbol(symbol);
 
                     std::cout << "[Listener] Snapshot: symbol=" << symbol
                               << " seq=" << snap->last_md_seq_num
                               << " bids=" << snap->bid_count
                               << " asks=" << snap->ask_count << "\n";
+                }
 
-                    offset += snap->header.length;
-
-                    uint32_t total_orders = snap->bid_count + snap->ask_count;
-                    for (uint32_t j = 0; j < total_orders && offset < bytes; ++j) {
-                        if (offset + (ssize_t)sizeof(new_order) > bytes) break;
-                        new_order* om = reinterpret_cast<new_order*>(buf + offset);
-                        if (om->header.msg_type != MSG_TYPE::NEW_ORDER) break;
-                        dispatch_new_order(om);
-                        offset += om->header.length;
-                    }
+                offset += snap->header.length;
 
-                    received_snapshot = true;
-                    no_replay_count   = 0;
+                uint32_t total_orders = snap->bid_count + snap->ask_count;
+                snapshot_orders.clear();
+                for (uint32_t j = 0; j < total_orders && offset < bytes; ++j) {
+                    if (offset + (ssize_t)sizeof(new_order) > bytes) break;
+                    new_order* om = reinterpret_cast<new_order*>(buf + offset);
+                    if (om->header.msg_type != MSG_TYPE::NEW_ORDER) break;
+                    if (load) snapshot_orders.push_back(om);
+                    offset += om->header.length;
                 }
-                continue;
-            }
+                if (!load) continue;
+
+                // Build the book in one batch, then route the ids
+                sm.load_snapshot(symbol, snapshot_orders.data(), snapshot_orders.size());
+                for (const new_order* om : snapshot_orders)
+                    router.add(om->order_id, symbol);
 
-            // ── Normal market data ────────────────────────────────────────────
-            if (hdr->magic_number != MAGIC_NUMBER) continue;
-
-            switch (hdr->msg_type) {
-                case MSG_TYPE::NEW_ORDER:
-                    dispatch_new_order(reinterpret_cast<new_order*>(buf));
-                    break;
-                case MSG_TYPE::DELETE_ORDER:
-                    dispatch_delete_order(reinterpret_cast<delete_order*>(buf));
-                    break;
-                case MSG_TYPE::MODIFY_ORDER:
-                    dispatch_modify_order(reinterpret_cast<modify_order*>(buf));
-                    break;
-                case MSG_TYPE::TRADE:
-                    dispatch_trade(reinterpret_cast<trade*>(buf));
-                    break;
-                case MSG_TYPE::HEARTBEAT:
-                    no_replay_count = 0;
-                    break;
-                default:
-                    break;
+                sm.set_last_seq_num(symbol, snap->last_md_seq_num);
+                recover_symbol(symbol, snap->last_md_seq_num);
             }
+            return;
+        }
 
-            no_replay_count = 0;
-            ++messages_processed;
+        // ── Normal market data ────────────────────────────────────────────────
+        if (hdr->magic_number != MAGIC_NUMBER) return;
 
-            if (messages_processed % 5000 == 0) {
-                std::cout << "[Listener] " << messages_processed
-                          << " messages processed\n";
-            }
+        on_live_message(buf, bytes, fd == live_sock);
+        feed_ts = hdr->timestamp;
+
+        ++messages_processed;
+
+        if (messages_processed % 5000 == 0) {
+            std::cout << "[Listener] " << messages_processed
+                      << " messages processed\n";
+            batch->print_stats();
+        }
+    };
+
+    std::cout << "[Listener] Starting market data feed...\n";
+
+    while (true) {
+        epoll_event events[16];
+        int nfds = epoll_wait(epoll_fd, events, 16, -1);
+
+        if (nfds < 0) {
+            std::cerr << "[Listener] epoll_wait failed: " << strerror(errno) << "\n";
+            return;
+        }
+
+        // ── Process incoming packets ──────────────────────────────────────────
+        // Drain each ready socket in batches; a short batch means it is empty.
+        // Everything drained on one wakeup is published as one epoch.
+        sm.begin_batch();
+        for (int i = 0; i < nfds; ++i) {
+            int fd = events[i].data.fd;
+            int n;
+            do {
+                n = batch->receive(fd);
+                for (int k = 0; k < n; ++k)
+                    handle_packet(fd, batch->data[k],
+                                  static_cast<ssize_t>(batch->length(k)));
+            } while (n == static_cast<int>(RECV_BATCH));
         }
+        sm.end_batch(feed_ts);
     }
 
     close(epoll_fd);
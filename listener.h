@@ -1,7 +1,17 @@
 #pragma once
 #include "symbol_manager.h"
+#include "order_router.h"
 
 // Runs the market data listener loop. Blocks forever.
 // Call this on a dedicated thread from main.cpp.
 // All book updates are forwarded into `sm` via the SymbolManager interface.
-void run_listener(SymbolManager& sm);
\ No newline at end of file
+void run_listener(SymbolManager& sm);
+
+// Symbol a market data message belongs to — new orders carry it, the rest
+// are routed by order id — or 0 if the order (or the symbol) is unknown.
+uint32_t route_md_message(const SymbolManager& sm, const OrderRouter& router, const md_header* hdr);
+
+// Apply a routed message to `symbol`'s book and keep `router` in step: an
+// order is routed only once the book has accepted it, and stops being
+// routed when it is deleted or fully traded.
+void apply_md_message(SymbolManager& sm, OrderRouter& router, uint32_t symbol, char* buf);
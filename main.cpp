@@ -1,4 +1,5 @@
 #include <thread>
+#include <array>
 #include <iostream>
 #include <atomic>
 #include <unordered_map>
@@ -21,10 +22,19 @@ static constexpr const char* TEAM_NAME     = "group8";
 static constexpr const char* PASSWORD      = "Uangjrty";
 static constexpr uint32_t    CLIENT_ID     = 8;
 
-static constexpr uint32_t GOLD_TICK = 10;
-static constexpr uint32_t BLUE_TICK = 5;
+// Symbol universe and ETF basket; the built-in table is used if absent
+static constexpr const char* SYMBOL_CONFIG    = "symbols.txt";
+// Positions and PnL, journalled on every fill and replayed at startup
+static constexpr const char* POSITION_JOURNAL = "positions.journal";
+// Pre-journal position file; startup refuses to run over it
+static constexpr const char* LEGACY_POSITIONS = "positions.txt";
+
 static constexpr int32_t  MM_POSITION_LIMIT = 4;
 
+// BUSY_POLL when the bot thread has an isolated core to itself;
+// SPIN_THEN_PARK sleeps between market data updates
+static constexpr WaitMode STRATEGY_WAIT_MODE = WaitMode::SPIN_THEN_PARK;
+
 int main() {
     // Crash handlers — must be before anything else
     std::signal(SIGSEGV, [](int sig) {
@@ -43,8 +53,16 @@ int main() {
     });
 
     // ── Shared state ──────────────────────────────────────────────────────────
-    SymbolManager       sm;
-    sm.load_positions("positions.txt");
+    SymbolConfig config = SymbolConfig::defaults();
+    if (!config.load(SYMBOL_CONFIG)) {
+        std::cerr << "Invalid symbol config " << SYMBOL_CONFIG << "\n";
+        return 1;
+    }
+    SymbolManager       sm(config);
+    if (!sm.open_journal(POSITION_JOURNAL, LEGACY_POSITIONS)) {
+        std::cerr << "Cannot use position journal " << POSITION_JOURNAL << "\n";
+        return 1;
+    }
     std::atomic<bool>   global_shutdown{false};
 
     // order_id → {symbol, side} for fill routing from market maker
@@ -60,6 +78,12 @@ int main() {
         std::cerr << "Login failed\n";
         return 1;
     }
+    // Responses are read on their own thread from here on; the strategy
+    // drains them with dispatch_events() and is woken when they arrive
+    if (!oe.start_async([&sm]() { sm.wake(); })) {
+        std::cerr << "Failed to start order-entry reader\n";
+        return 1;
+    }
 
     // Fill callback for market maker orders
     // (ETFArb registers its own fill callback in its constructor,
@@ -91,7 +115,7 @@ int main() {
 
     static SymbolManager* g_sm = &sm;
     std::signal(SIGINT, [](int) {
-        if (g_sm) g_sm->save_positions("positions.txt");
+        if (g_sm) g_sm->sync_journal();
         std::exit(0);
     });
 
@@ -100,23 +124,33 @@ int main() {
         run_listener(sm);
     });
 
-    // Wait for books to populate
-    std::cout << "Waiting 3s for market data snapshot...\n";
-    std::this_thread::sleep_for(std::chrono::seconds(3));
+    // No warm-up wait: every book stays stale (reads as empty) until the
+    // listener has aligned it with its snapshot, so nothing trades early.
 
     // ── PnL monitor thread ────────────────────────────────────────────────────
+    // Also reports book anomalies, so the MD thread never logs on a bad feed
     std::thread pnl_thread([&]() {
+        std::array<uint64_t, MAX_SYMBOLS> anomalies_seen{};
         while (!global_shutdown.load(std::memory_order_acquire)) {
             std::this_thread::sleep_for(std::chrono::seconds(5));
-            double pnl = sm.get_total_pnl();
-            std::cout << "[PnL] total=" << pnl << " | positions: ";
-            for (uint32_t id = 1; id <= 13; ++id) {
+            PnlSummary pnl = sm.pnl();
+            std::cout << "[PnL] total=" << pnl.total() << " (realized=" << pnl.realized
+                      << " unrealized=" << pnl.unrealized << ") | positions: ";
+            for (uint32_t id : sm.config().ids()) {
                 int32_t pos = sm.get_position(id);
                 if (pos != 0) std::cout << "sym" << id << "=" << pos << " ";
             }
             std::cout << "\n";
-            if (pnl < -4000.0)
+            if (pnl.total() < -4000)
                 std::cerr << "[PnL] WARNING: approaching -5000 floor!\n";
+
+            for (uint32_t id : sm.config().ids()) {
+                const BookAnomalies& a = sm.anomalies(id);
+                uint64_t total = a.total();
+                if (total == anomalies_seen[id]) continue;
+                anomalies_seen[id] = total;
+                a.print(std::cerr, id);
+            }
         }
     });
     pnl_thread.detach();
@@ -251,8 +285,13 @@ int main() {
     //     arb.run();
     // });
 
+    // BLUE quotes on its configured grid
+    uint32_t blue_id   = sm.config().find("BLUE");
+    uint32_t blue_tick = blue_id ? static_cast<uint32_t>(sm.config().symbol(blue_id).tick) : 1;
+
+    arb.set_wait_mode(STRATEGY_WAIT_MODE);
     std::thread bot_thread([&]() {
-    arb.run_with_mm(7, BLUE_TICK);
+    arb.run_with_mm(7, blue_tick);
     });
     md_thread.join();
     bot_thread.join();
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ── ObjectPool ────────────────────────────────────────────────────────────────
+//
+// Slab allocator for fixed-size records. Memory is taken from the heap in
+// slabs of SLAB objects and never returned; freed objects go on an intrusive
+// free list and are handed out again first. Once the pool has grown to the
+// working set, allocate() and release() are a couple of pointer moves.
+//
+// Objects never move, so pointers to them stay valid until release().
+// Objects still allocated when the pool dies are not destroyed, hence the
+// trivially-destructible requirement. Single-threaded.
+
+template <typename T, size_t SLAB = 4096>
+class ObjectPool {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "ObjectPool records must be trivially destructible");
+public:
+    explicit ObjectPool(size_t reserve = SLAB) {
+        while (capacity_ < reserve) grow();
+    }
+
+    ObjectPool(ObjectPool&& o) noexcept { *this = std::move(o); }
+    ObjectPool& operator=(ObjectPool&& o) noexcept {
+        slabs_    = std::move(o.slabs_);
+        free_     = std::exchange(o.free_, nullptr);
+        capacity_ = std::exchange(o.capacity_, 0);
+        in_use_   = std::exchange(o.in_use_, 0);
+        return *this;
+    }
+
+    template <typename... Args>
+    T* allocate(Args&&... args) {
+        if (!free_) grow();
+        FreeNode* n = free_;
+        free_ = n->next;
+        ++in_use_;
+        return new (n) T(std::forward<Args>(args)...);
+    }
+
+    void release(T* obj) {
+        FreeNode* n = reinterpret_cast<FreeNode*>(obj);
+        n->next = free_;
+        free_   = n;
+        --in_use_;
+    }
+
+    size_t in_use()   const { return in_use_; }
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct FreeNode { FreeNode* next; };
+
+    // A slot holds either a live T or a free-list link
+    union Storage {
+        alignas(T) unsigned char bytes[sizeof(T)];
+        FreeNode link;
+    };
+
+    std::vector<std::unique_ptr<Storage[]>> slabs_;
+    FreeNode* free_     = nullptr;
+    size_t    capacity_ = 0;
+    size_t    in_use_   = 0;
+
+    void grow() {
+        slabs_.emplace_back(new Storage[SLAB]);
+        Storage* slab = slabs_.back().get();
+        // Thread the new slab onto the free list in address order
+        for (size_t i = SLAB; i-- > 0; ) {
+            FreeNode* n = reinterpret_cast<FreeNode*>(&slab[i]);
+            n->next = free_;
+            free_   = n;
+        }
+        capacity_ += SLAB;
+    }
+};
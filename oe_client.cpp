@@ -1,7 +1,12 @@
 #include "oe_client.h"
 #include <sys/socket.h>
 #include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
 #include <unistd.h>
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <iostream>
 #include <fstream>
@@ -9,11 +14,16 @@
 #include <chrono>
 
 std::ofstream logfile("oe_log.txt");
+static std::mutex logfile_mutex;   // whole-buffer writes to logfile, in order
 
 OEClient::OEClient(const char* host, int port)
-    : host_(host), port_(port), sock_fd_(-1), session_id_(0), seq_num_(0) {}
+    : host_(host), port_(port), sock_fd_(-1), session_id_(0), seq_num_(0), client_id_(0) {
+    templates_.build(client_id_, session_id_);
+}
 
 OEClient::~OEClient() {
+    stop_async();
+    flush_log();
     if (sock_fd_ >= 0) close(sock_fd_);
 }
 
@@ -31,6 +41,10 @@ bool OEClient::connect() {
         std::cerr << "Connect failed: " << strerror(errno) << std::endl;
         return false;
     }
+    // Orders are small and latency-bound: never hold one back for Nagle
+    int one = 1;
+    setsockopt(sock_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    rx_.reset();
     std::cout << "Connected to " << host_ << ":" << port_ << std::endl;
     return true;
 }
@@ -52,50 +66,76 @@ bool OEClient::login(const char* username, const char* password, uint32_t client
 
     send_raw(&msg, sizeof(msg));
 
-    char buf[256];
     size_t len;
-    if (!read_response(buf, len)) return false;
+    const char* buf = read_response(len);
+    if (!buf) return false;
 
-    auto* resp = reinterpret_cast<ndfex::oe::login_response*>(buf);
+    auto* resp = reinterpret_cast<const ndfex::oe::login_response*>(buf);
     if (resp->status != (uint8_t)ndfex::oe::LOGIN_STATUS::SUCCESS) {
         std::cerr << "Login failed, status: " << (int)resp->status << std::endl;
         return false;
     }
 
     session_id_ = resp->session_id;
+    templates_.build(client_id_, session_id_);
     std::cout << "Login successful, session_id: " << session_id_ << std::endl;
     return true;
 }
 
 void OEClient::send_raw(const void* data, size_t len) {
-    send(sock_fd_, data, len, 0);
+    send_all(data, len, 0);
     log_message("SENT", data, len);
 }
 
-bool OEClient::read_response(char* buf, size_t& out_len) {
-    ndfex::oe::oe_response_header hdr;
-    size_t total = 0;
-    while (total < sizeof(hdr)) {
-        ssize_t n = recv(sock_fd_, (char*)&hdr + total, sizeof(hdr) - total, 0);
-        if (n <= 0) return false;
-        total += n;
+// A blocking send can still return short (signal, full buffer): finish it
+bool OEClient::send_all(const void* data, size_t len, int flags) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = send(sock_fd_, p, len, flags | MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[OEClient] send failed: " << strerror(errno) << "\n";
+            return false;
+        }
+        p   += n;
+        len -= static_cast<size_t>(n);
     }
+    return true;
+}
+
+// Patch the (symbol, side) template with the next seq_num and enter the
+// order in the table
+ndfex::oe::new_order& OEClient::stage_new_order(uint64_t order_id, uint32_t symbol,
+                                                SIDE side, uint32_t qty, int32_t price) {
+    orders_.insert(order_id, OrderState{ OrderStatus::PENDING, 0, false, qty, 0, price });
+    return templates_.new_order(++seq_num_, order_id, symbol, side, qty, price);
+}
 
-    memcpy(buf, &hdr, sizeof(hdr));
-    size_t remaining = hdr.length - sizeof(hdr);
-    total = 0;
-    while (total < remaining) {
-        ssize_t n = recv(sock_fd_, buf + sizeof(hdr) + total, remaining - total, 0);
-        if (n <= 0) return false;
-        total += n;
+// Next response frame, reading the socket only once the buffer holds no
+// complete one. nullptr on disconnect or a malformed frame.
+const char* OEClient::read_response(size_t& len) {
+    while (true) {
+        if (const char* frame = take_frame(len)) return frame;
+        if (rx_.malformed()) {
+            std::cerr << "[OEClient] Malformed response frame — dropping session\n";
+            return nullptr;
+        }
+        ssize_t n = rx_.fill(sock_fd_);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return nullptr;
     }
+}
 
-    out_len = hdr.length;
-    log_message("RECV", buf, out_len);
-    return true;
+// A complete frame already buffered, without touching the socket
+const char* OEClient::take_frame(size_t& len) {
+    const char* frame = rx_.next(len);
+    if (frame) log_message("RECV", frame, len);
+    return frame;
 }
 
 bool OEClient::wait_for_response(uint64_t expected_order_id) {
+    if (async_) return await_event(expected_order_id, false, std::chrono::milliseconds(3000));
+
     auto deadline = std::chrono::steady_clock::now()
                   + std::chrono::milliseconds(3000);
 
@@ -106,15 +146,16 @@ bool OEClient::wait_for_response(uint64_t expected_order_id) {
             return false;
         }
 
-    char buf[256];
     size_t len;
     while (true) {
-        if (!read_response(buf, len)) return false;
-        auto* hdr = reinterpret_cast<ndfex::oe::oe_response_header*>(buf);
+        const char* buf = read_response(len);
+        if (!buf) return false;
+        auto* hdr = reinterpret_cast<const ndfex::oe::oe_response_header*>(buf);
+        OeEvent ev;
+        if (decode_response(buf, ev)) track(ev);
 
         if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::ACK) {
-            auto* ack = reinterpret_cast<ndfex::oe::order_ack*>(buf);
-            live_orders_.insert(ack->order_id);
+            auto* ack = reinterpret_cast<const ndfex::oe::order_ack*>(buf);
             if (ack->order_id == expected_order_id) {
                 std::cout << "ACKed! order_id=" << ack->order_id << std::endl;
                 return true;
@@ -127,7 +168,7 @@ bool OEClient::wait_for_response(uint64_t expected_order_id) {
             continue;
 
         } else if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::REJECT) {
-            auto* rej = reinterpret_cast<ndfex::oe::order_reject*>(buf);
+            auto* rej = reinterpret_cast<const ndfex::oe::order_reject*>(buf);
             std::cerr << "[OEClient] REJECTED order_id=" << rej->order_id
                       << " reason=" << (int)rej->reject_reason << std::endl;
             if (on_reject_cb_) on_reject_cb_(rej->order_id);
@@ -149,7 +190,7 @@ bool OEClient::wait_for_response(uint64_t expected_order_id) {
 
 
         } else if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::FILL) {
-            auto* fill = reinterpret_cast<ndfex::oe::order_fill*>(buf);
+            auto* fill = reinterpret_cast<const ndfex::oe::order_fill*>(buf);
             bool closed = (fill->flags == (uint8_t)ndfex::oe::FILL_FLAGS::CLOSED);
 
             if (on_fill_cb_) {
@@ -163,14 +204,12 @@ bool OEClient::wait_for_response(uint64_t expected_order_id) {
 
 
             if (closed) {
-                live_orders_.erase(fill->order_id);
                 std::cout << "Order fully filled and closed." << std::endl;
                 return true;
             }
 
         } else if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::CLOSE) {
-            auto* cl = reinterpret_cast<ndfex::oe::order_closed*>(buf);
-            live_orders_.erase(cl->order_id);
+            auto* cl = reinterpret_cast<const ndfex::oe::order_closed*>(buf);
             std::cout << "Order closed. order_id=" << cl->order_id << std::endl;
             if (on_close_cb_) on_close_cb_(cl->order_id);
             return true;
@@ -178,91 +217,91 @@ bool OEClient::wait_for_response(uint64_t expected_order_id) {
         }
     }
 }
+// ── Session log ───────────────────────────────────────────────────────────────
+// The sender and the reader thread both log every message. Each formats its
+// line on its own thread, and log_mutex_ covers only the append to log_buf_.
+// Once LOG_FLUSH_BYTES have piled up, the appender hands the buffer over
+// and writes it after dropping log_mutex_, so the file write — the only
+// syscall — never holds up the other thread's logging.
+
 void OEClient::log_message(const char* direction, const void* data, size_t len) {
-    logfile << direction << " [" << len << " bytes]: ";
+    static constexpr char HEX[] = "0123456789abcdef";
+    thread_local std::string line;
+    line.assign(direction);
+    line += " [";
+    line += std::to_string(len);
+    line += " bytes]: ";
     const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
     for (size_t i = 0; i < len; i++) {
-        logfile << std::hex << (int)bytes[i] << " ";
+        if (bytes[i] >= 0x10) line += HEX[bytes[i] >> 4];
+        line += HEX[bytes[i] & 0xf];
+        line += ' ';
     }
-    logfile << std::dec << "\n";
+    line += '\n';
+    log_append(line);
+}
+
+void OEClient::log_append(const std::string& text) {
+    std::unique_lock<std::mutex> lock(log_mutex_);
+    log_buf_ += text;
+    if (log_buf_.size() < LOG_FLUSH_BYTES) return;
+
+    // Take the file before letting go of the buffer, so buffers reach the
+    // file in the order they filled
+    std::lock_guard<std::mutex> write(logfile_mutex);
+    log_out_.swap(log_buf_);
+    lock.unlock();
+    logfile.write(log_out_.data(), static_cast<std::streamsize>(log_out_.size()));
+    logfile.flush();
+    log_out_.clear();
+}
+
+void OEClient::flush_log() {
+    std::lock_guard<std::mutex> lock(log_mutex_);
+    std::lock_guard<std::mutex> write(logfile_mutex);
+    logfile.write(log_buf_.data(), static_cast<std::streamsize>(log_buf_.size()));
     logfile.flush();
+    log_buf_.clear();
 }
 
 bool OEClient::send_new_order(uint64_t order_id, uint32_t symbol,
                                SIDE side, uint32_t qty, int32_t price) {
-    ndfex::oe::new_order msg{};
-    msg.header.length     = sizeof(msg);
-    msg.header.msg_type   = (uint8_t)ndfex::oe::MSG_TYPE::NEW_ORDER;
-    msg.header.version    = ndfex::oe::OE_PROTOCOL_VERSION;
-    msg.header.seq_num    = ++seq_num_;
-    msg.header.client_id  = client_id_;
-    msg.header.session_id = session_id_;
-    msg.order_id          = order_id;
-    msg.symbol            = symbol;
-    msg.side              = side;
-    msg.quantity          = qty;
-    msg.price             = price;
-    msg.flags             = 0;
-
+    auto& msg = stage_new_order(order_id, symbol, side, qty, price);
     send_raw(&msg, sizeof(msg));
+    if (async_) return true;
     return wait_for_response(order_id);
 }
 
 void OEClient::send_new_order_no_wait(uint64_t order_id, uint32_t symbol,
                                        SIDE side, uint32_t qty, int32_t price) {
-    ndfex::oe::new_order msg{};
-    msg.header.length     = sizeof(msg);
-    msg.header.msg_type   = (uint8_t)ndfex::oe::MSG_TYPE::NEW_ORDER;
-    msg.header.version    = ndfex::oe::OE_PROTOCOL_VERSION;
-    msg.header.seq_num    = ++seq_num_;
-    msg.header.client_id  = client_id_;
-    msg.header.session_id = session_id_;
-    msg.order_id          = order_id;
-    msg.symbol            = symbol;
-    msg.side              = side;
-    msg.quantity          = qty;
-    msg.price             = price;
-    msg.flags             = 0;
-
+    auto& msg = stage_new_order(order_id, symbol, side, qty, price);
     send_raw(&msg, sizeof(msg));
     // No wait_for_response() — caller collects ACKs separately
 }
 
 bool OEClient::delete_order(uint64_t order_id) {
-    ndfex::oe::delete_order msg{};
-    msg.header.length     = sizeof(msg);
-    msg.header.msg_type   = (uint8_t)ndfex::oe::MSG_TYPE::DELETE_ORDER;
-    msg.header.version    = ndfex::oe::OE_PROTOCOL_VERSION;
-    msg.header.seq_num    = ++seq_num_;
-    msg.header.client_id  = client_id_;
-    msg.header.session_id = session_id_;
-    msg.order_id          = order_id;
+    auto& msg = templates_.delete_order(++seq_num_, order_id);
 
     send_raw(&msg, sizeof(msg));
+    if (async_) return true;
     return wait_for_response(order_id);
 }
 
 bool OEClient::modify_order(uint64_t order_id, SIDE side,
                              uint32_t qty, int32_t price) {
-    ndfex::oe::modify_order msg{};
-    msg.header.length     = sizeof(msg);
-    msg.header.msg_type   = (uint8_t)ndfex::oe::MSG_TYPE::MODIFY_ORDER;
-    msg.header.version    = ndfex::oe::OE_PROTOCOL_VERSION;
-    msg.header.seq_num    = ++seq_num_;
-    msg.header.client_id  = client_id_;
-    msg.header.session_id = session_id_;
-    msg.order_id          = order_id;
-    msg.side              = side;
-    msg.quantity          = qty;
-    msg.price             = price;
+    auto& msg = templates_.modify_order(++seq_num_, order_id, side, qty, price);
 
     send_raw(&msg, sizeof(msg));
+    if (async_) return true;
     return wait_for_response(order_id);
 }
 
 void OEClient::cancel_all_open_orders() {
     // Snapshot to avoid mutation while iterating
-    std::vector<uint64_t> to_cancel(live_orders_.begin(), live_orders_.end());
+    std::vector<uint64_t> to_cancel;
+    orders_.for_each([&](uint64_t id, OrderState& o) {
+        if (o.status == OrderStatus::LIVE) to_cancel.push_back(id);
+    });
     std::cout << "cancel_all_open_orders: " << to_cancel.size() << " orders" << std::endl;
     for (uint64_t oid : to_cancel) {
         delete_order(oid);
@@ -328,6 +367,8 @@ void OEClient::cancel_all_open_orders() {
 // }
 
 bool OEClient::wait_for_fill(uint64_t expected_order_id) {
+    if (async_) return await_event(expected_order_id, true, std::chrono::milliseconds(5000));
+
     auto deadline = std::chrono::steady_clock::now()
                   + std::chrono::milliseconds(5000);
 
@@ -338,21 +379,22 @@ bool OEClient::wait_for_fill(uint64_t expected_order_id) {
             return false;
         }
 
-        char buf[256];
         size_t len;
-        if (!read_response(buf, len)) return false;
+        const char* buf = read_response(len);
+        if (!buf) return false;
 
-        auto* hdr = reinterpret_cast<ndfex::oe::oe_response_header*>(buf);
+        auto* hdr = reinterpret_cast<const ndfex::oe::oe_response_header*>(buf);
+        OeEvent ev;
+        if (decode_response(buf, ev)) track(ev);
 
         if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::FILL) {
-            auto* fill = reinterpret_cast<ndfex::oe::order_fill*>(buf);
+            auto* fill = reinterpret_cast<const ndfex::oe::order_fill*>(buf);
             bool closed = (fill->flags == (uint8_t)ndfex::oe::FILL_FLAGS::CLOSED);
 
             // Always fire callback — keeps MM positions accurate
             if (on_fill_cb_)
                 on_fill_cb_(FillEvent{fill->order_id, fill->quantity,
                                       fill->price, closed});
-            if (closed) live_orders_.erase(fill->order_id);
 
             std::cout << "[OEClient] wait_for_fill: FILL order_id=" << fill->order_id
                       << " qty=" << fill->quantity
@@ -369,14 +411,13 @@ bool OEClient::wait_for_fill(uint64_t expected_order_id) {
                             : " — other order, continuing\n");
 
         } else if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::ACK) {
-            auto* ack = reinterpret_cast<ndfex::oe::order_ack*>(buf);
-            live_orders_.insert(ack->order_id);
+            auto* ack = reinterpret_cast<const ndfex::oe::order_ack*>(buf);
             std::cout << "[OEClient] wait_for_fill: ACK order_id="
                       << ack->order_id << " (waiting for fill on "
                       << expected_order_id << ")\n";
 
         } else if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::REJECT) {
-            auto* rej = reinterpret_cast<ndfex::oe::order_reject*>(buf);
+            auto* rej = reinterpret_cast<const ndfex::oe::order_reject*>(buf);
             if (on_reject_cb_) on_reject_cb_(rej->order_id);
             std::cerr << "[OEClient] wait_for_fill: REJECT order_id="
                       << rej->order_id << " reason=" << (int)rej->reject_reason;
@@ -387,8 +428,7 @@ bool OEClient::wait_for_fill(uint64_t expected_order_id) {
             std::cerr << " — other order\n";
 
         } else if (hdr->msg_type == (uint8_t)ndfex::oe::MSG_TYPE::CLOSE) {
-            auto* cl = reinterpret_cast<ndfex::oe::order_closed*>(buf);
-            live_orders_.erase(cl->order_id);
+            auto* cl = reinterpret_cast<const ndfex::oe::order_closed*>(buf);
             if (on_close_cb_) on_close_cb_(cl->order_id);
             std::cout << "[OEClient] wait_for_fill: CLOSE order_id="
                       << cl->order_id << "\n";
@@ -396,3 +436,341 @@ bool OEClient::wait_for_fill(uint64_t expected_order_id) {
         }
     }
 }
+
+// ── Async mode ────────────────────────────────────────────────────────────────
+
+bool OEClient::start_async(std::function<void()> on_ready) {
+    if (async_) return true;
+    if (sock_fd_ < 0 || session_id_ == 0) {
+        std::cerr << "[OEClient] start_async needs a logged-in session\n";
+        return false;
+    }
+    on_ready_ = std::move(on_ready);
+    reader_stop_.store(false, std::memory_order_relaxed);
+    reader_ = std::thread(&OEClient::reader_loop, this);
+    async_  = true;
+    return true;
+}
+
+void OEClient::stop_async() {
+    if (!async_) return;
+    reader_stop_.store(true, std::memory_order_release);
+    reader_.join();
+    async_ = false;
+}
+
+bool OEClient::decode_response(const char* buf, OeEvent& ev) {
+    using ndfex::oe::MSG_TYPE;
+    auto* hdr = reinterpret_cast<const ndfex::oe::oe_response_header*>(buf);
+    ev = OeEvent{};
+
+    switch (static_cast<MSG_TYPE>(hdr->msg_type)) {
+    case MSG_TYPE::ACK: {
+        auto* m     = reinterpret_cast<const ndfex::oe::order_ack*>(buf);
+        ev.type     = OeEvent::Type::ACK;
+        ev.order_id = m->order_id;
+        ev.qty      = m->quantity;
+        ev.price    = m->price;
+        return true;
+    }
+    case MSG_TYPE::REJECT: {
+        auto* m          = reinterpret_cast<const ndfex::oe::order_reject*>(buf);
+        ev.type          = OeEvent::Type::REJECT;
+        ev.order_id      = m->order_id;
+        ev.reject_reason = m->reject_reason;
+        return true;
+    }
+    case MSG_TYPE::FILL: {
+        auto* m     = reinterpret_cast<const ndfex::oe::order_fill*>(buf);
+        ev.type     = OeEvent::Type::FILL;
+        ev.order_id = m->order_id;
+        ev.qty      = m->quantity;
+        ev.price    = m->price;
+        ev.closed   = m->flags == (uint8_t)ndfex::oe::FILL_FLAGS::CLOSED;
+        return true;
+    }
+    case MSG_TYPE::CLOSE: {
+        auto* m     = reinterpret_cast<const ndfex::oe::order_closed*>(buf);
+        ev.type     = OeEvent::Type::CLOSE;
+        ev.order_id = m->order_id;
+        return true;
+    }
+    case MSG_TYPE::ERROR:
+        ev.type = OeEvent::Type::ERROR;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Reader thread: the only reader of the socket while async. Polls with a
+// short timeout so stop_async() is noticed; never drops an event — if the
+// strategy falls a whole queue behind, it waits for room.
+void OEClient::reader_loop() {
+    pollfd pfd{ sock_fd_, POLLIN, 0 };
+
+    auto publish = [&](const OeEvent& ev) {
+        while (!events_.try_push(ev)) {
+            if (reader_stop_.load(std::memory_order_acquire)) return;
+            std::this_thread::yield();
+        }
+    };
+    auto disconnect = [&]() {
+        publish(OeEvent{ OeEvent::Type::DISCONNECT, false, 0, 0, 0, 0 });
+        if (on_ready_) on_ready_();
+    };
+
+    while (!reader_stop_.load(std::memory_order_acquire)) {
+        // Everything one read brought in goes out as one batch
+        size_t      len;
+        size_t      queued = 0;
+        OeEvent     ev;
+        while (const char* frame = take_frame(len))
+            if (decode_response(frame, ev)) { publish(ev); ++queued; }
+        if (queued && on_ready_) on_ready_();
+        if (rx_.malformed()) {
+            std::cerr << "[OEClient] Malformed response frame — dropping session\n";
+            disconnect();
+            return;
+        }
+
+        int ready = poll(&pfd, 1, 100);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready == 0) continue;
+        ssize_t n = ready > 0 ? rx_.fill(sock_fd_) : -1;
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            disconnect();
+            return;
+        }
+    }
+}
+
+// Strategy thread: the bookkeeping and callbacks the blocking waits do
+void OEClient::apply_event(const OeEvent& ev) {
+    track(ev);
+    switch (ev.type) {
+    case OeEvent::Type::ACK:
+        break;
+    case OeEvent::Type::REJECT:
+        std::cerr << "[OEClient] REJECTED order_id=" << ev.order_id
+                  << " reason=" << (int)ev.reject_reason << "\n";
+        if (on_reject_cb_) on_reject_cb_(ev.order_id);
+        break;
+    case OeEvent::Type::FILL:
+        if (on_fill_cb_) on_fill_cb_(FillEvent{ ev.order_id, ev.qty, ev.price, ev.closed });
+        break;
+    case OeEvent::Type::CLOSE:
+        if (on_close_cb_) on_close_cb_(ev.order_id);
+        break;
+    case OeEvent::Type::ERROR:
+        std::cerr << "[OEClient] ERROR message from exchange\n";
+        break;
+    case OeEvent::Type::DISCONNECT:
+        std::cerr << "[OEClient] Exchange connection lost\n";
+        connected_ = false;
+        break;
+    }
+}
+
+size_t OEClient::dispatch_events() {
+    OeEvent ev;
+    size_t  n = 0;
+    while (events_.try_pop(ev)) {
+        apply_event(ev);
+        ++n;
+    }
+    return n;
+}
+
+// Async counterpart of wait_for_response() (until_fill false: ACK, or a
+// close or fully-filling fill) and wait_for_fill() (until_fill true).
+// Every event drained on the way is applied, whoever it is for.
+bool OEClient::await_event(uint64_t order_id, bool until_fill,
+                           std::chrono::milliseconds timeout) {
+    auto    deadline = std::chrono::steady_clock::now() + timeout;
+    OeEvent ev;
+    while (true) {
+        if (!events_.try_pop(ev)) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                std::cerr << "[OEClient] Timeout waiting for order_id=" << order_id << "\n";
+                return false;
+            }
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+            continue;
+        }
+
+        apply_event(ev);
+        if (ev.type == OeEvent::Type::DISCONNECT) return false;
+        if (ev.order_id != order_id) continue;
+
+        switch (ev.type) {
+        case OeEvent::Type::ACK:
+            if (!until_fill) return true;
+            break;
+        case OeEvent::Type::REJECT:
+            return !until_fill
+                && ev.reject_reason == (uint8_t)ndfex::oe::REJECT_REASON::UKNOWN_ORDER_ID;
+        case OeEvent::Type::FILL:
+            if (ev.closed) return true;
+            break;
+        case OeEvent::Type::CLOSE:
+            return !until_fill;
+        default:
+            break;
+        }
+    }
+}
+
+// ── Open-order table ──────────────────────────────────────────────────────────
+// Strategy thread only: fed by apply_event() when async, and by the blocking
+// waits as they read the socket otherwise.
+
+void OEClient::track(const OeEvent& ev) {
+    OrderState* o = orders_.find(ev.order_id);
+    switch (ev.type) {
+    case OeEvent::Type::ACK:
+        // An ACK for a modify carries the new quantity and price
+        if (!o) o = orders_.insert(ev.order_id, OrderState{ OrderStatus::LIVE, 0, false, ev.qty, 0, ev.price });
+        if (o->status == OrderStatus::PENDING) o->status = OrderStatus::LIVE;
+        o->qty   = ev.qty;
+        o->price = ev.price;
+        return;
+    case OeEvent::Type::REJECT:
+        if (!o) return;
+        if (o->status == OrderStatus::PENDING) {
+            o->status        = OrderStatus::REJECTED;
+            o->reject_reason = ev.reject_reason;
+        } else if (ev.reject_reason == (uint8_t)ndfex::oe::REJECT_REASON::UKNOWN_ORDER_ID) {
+            o->status = OrderStatus::CLOSED;      // already gone at the exchange
+        } else {
+            return;                               // a modify or delete refused; the order stands
+        }
+        break;
+    case OeEvent::Type::FILL:
+        if (!o) return;
+        o->filled_qty += ev.qty;
+        if (o->status == OrderStatus::PENDING) o->status = OrderStatus::LIVE;
+        if (!ev.closed) return;
+        o->status = OrderStatus::FILLED;
+        break;
+    case OeEvent::Type::CLOSE:
+        if (!o) return;
+        o->status = OrderStatus::CLOSED;
+        break;
+    default:
+        return;
+    }
+    if (!o->tracked) orders_.erase(ev.order_id);
+}
+
+// ── Completion handles ────────────────────────────────────────────────────────
+
+OrderHandle OEClient::submit_new_order(uint64_t order_id, uint32_t symbol, SIDE side,
+                                       uint32_t qty, int32_t price) {
+    send_new_order_no_wait(order_id, symbol, side, qty, price);
+    orders_.find(order_id)->tracked = true;
+    return OrderHandle{ order_id };
+}
+
+void OEClient::release(OrderHandle h) {
+    OrderState* o = orders_.find(h.order_id);
+    if (!o) return;
+    if (o->done()) orders_.erase(h.order_id);
+    else           o->tracked = false;
+}
+
+// One send() per BURST_MAX orders and one log line per burst, rather than
+// a syscall and a hex dump per order
+bool OEClient::submit_burst(const OrderRequest* orders, size_t count, OrderHandle* handles) {
+    for (size_t base = 0; base < count; base += BURST_MAX) {
+        size_t n = std::min(BURST_MAX, count - base);
+        for (size_t i = 0; i < n; ++i) {
+            const OrderRequest& r = orders[base + i];
+            burst_buf_[i] = stage_new_order(r.order_id, r.symbol, r.side, r.qty, r.price);
+            orders_.find(r.order_id)->tracked = true;
+            handles[base + i] = OrderHandle{ r.order_id };
+        }
+        bool more = base + n < count;
+        if (!send_all(burst_buf_.data(), n * sizeof(ndfex::oe::new_order), more ? MSG_MORE : 0)) {
+            // The session is gone: this chunk and the rest never (fully)
+            // left. Settle their handles now rather than at the deadline.
+            for (size_t i = base; i < count; ++i) {
+                const OrderRequest& r = orders[i];
+                orders_.insert(r.order_id, OrderState{ OrderStatus::REJECTED, 0, true, r.qty, 0, r.price });
+                handles[i] = OrderHandle{ r.order_id };
+            }
+            connected_ = false;
+            return false;
+        }
+
+        log_append("SENT BURST [" + std::to_string(n) + " orders, "
+                   + std::to_string(n * sizeof(ndfex::oe::new_order)) + " bytes]: seq "
+                   + std::to_string(burst_buf_[0].header.seq_num) + ".."
+                   + std::to_string(burst_buf_[n - 1].header.seq_num) + "\n");
+    }
+    return true;
+}
+
+// An order the table does not know cannot be waited on; count it as satisfied
+bool OEClient::satisfied(uint64_t order_id, OrderWait until) const {
+    const OrderState* o = orders_.find(order_id);
+    if (!o) return true;
+    return until == OrderWait::RESPONSE ? o->responded() : o->done();
+}
+
+// Take and apply one response. False at the deadline or once disconnected.
+bool OEClient::next_event(Deadline deadline) {
+    using clock = std::chrono::steady_clock;
+    if (!connected_) return false;
+
+    OeEvent ev;
+    if (async_) {
+        while (!events_.try_pop(ev)) {
+            if (clock::now() > deadline) return false;
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+    } else {
+        size_t      len;
+        const char* frame = take_frame(len);
+        if (!frame && !rx_.malformed()) {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - clock::now());
+            if (left.count() <= 0) return false;
+            pollfd pfd{ sock_fd_, POLLIN, 0 };
+            int ready = poll(&pfd, 1, static_cast<int>(left.count()));
+            if (ready < 0 && errno == EINTR) return true;
+            if (ready == 0) return false;
+            ssize_t n = ready > 0 ? rx_.fill(sock_fd_) : -1;
+            if (n > 0 || (n < 0 && errno == EINTR)) return true;   // frames taken next call
+        }
+        if (!frame)
+            ev = OeEvent{ OeEvent::Type::DISCONNECT, false, 0, 0, 0, 0 };
+        else if (!decode_response(frame, ev))
+            return true;
+    }
+    apply_event(ev);
+    return connected_;
+}
+
+bool OEClient::wait_all(const OrderHandle* handles, size_t count,
+                        OrderWait until, Deadline deadline) {
+    size_t first_open = 0;   // handles before it are already satisfied
+    while (true) {
+        while (first_open < count && satisfied(handles[first_open].order_id, until)) ++first_open;
+        if (first_open == count) return true;
+        if (!next_event(deadline)) return false;
+    }
+}
+
+int OEClient::wait_any(const OrderHandle* handles, size_t count,
+                       OrderWait until, Deadline deadline) {
+    while (true) {
+        for (size_t i = 0; i < count; ++i)
+            if (satisfied(handles[i].order_id, until)) return static_cast<int>(i);
+        if (!next_event(deadline)) return -1;
+    }
+}
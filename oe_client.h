@@ -1,10 +1,19 @@
 #ifndef OE_CLIENT_H
 #define OE_CLIENT_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <functional>
-#include <unordered_set>
+#include <mutex>
+#include <string>
+#include <thread>
 #include "oe_messages.h"
 #include "iorder_sender.h"
+#include "spsc_queue.h"
+#include "flat_hash_map.h"
+#include "order_templates.h"
+#include "oe_frame_reader.h"
 
 // ── Fill event delivered via callback ────────────────────────────────────────
 
@@ -15,6 +24,63 @@ struct FillEvent {
     bool     closed; // true = order fully filled or otherwise closed
 };
 
+// ── Order-entry event ────────────────────────────────────────────────────────
+// One decoded exchange response, as the async reader thread hands it to the
+// strategy thread.
+
+struct OeEvent {
+    enum class Type : uint8_t { ACK, REJECT, FILL, CLOSE, ERROR, DISCONNECT };
+
+    Type     type;
+    bool     closed;          // FILL: order fully filled or otherwise closed
+    uint8_t  reject_reason;   // REJECT: ndfex::oe::REJECT_REASON
+    uint32_t qty;             // ACK, FILL
+    int32_t  price;           // ACK, FILL
+    uint64_t order_id;        // 0 for ERROR / DISCONNECT
+};
+
+// ── Open-order table entry ───────────────────────────────────────────────────
+// Every order sent through the client has one, from send until it is done:
+//   PENDING  sent, no response yet
+//   LIVE     ACK'd and resting (possibly partly filled)
+//   FILLED   fully filled            ┐
+//   CLOSED   closed by the exchange  ├ done
+//   REJECTED rejected before an ACK  ┘
+
+enum class OrderStatus : uint8_t { PENDING, LIVE, FILLED, CLOSED, REJECTED };
+
+struct OrderState {
+    OrderStatus status;
+    uint8_t     reject_reason;
+    bool        tracked;       // a handle is out: keep the entry once done
+    uint32_t    qty;
+    uint32_t    filled_qty;
+    int32_t     price;
+
+    bool responded() const { return status != OrderStatus::PENDING; }
+    bool done()      const { return status >= OrderStatus::FILLED; }
+};
+
+// Completion handle for one order: its id, resolved against the table
+struct OrderHandle {
+    uint64_t order_id = 0;
+};
+
+// One order of a burst
+struct OrderRequest {
+    uint64_t order_id;
+    uint32_t symbol;
+    SIDE     side;
+    uint32_t qty;
+    int32_t  price;
+};
+
+// What a wait over handles waits for
+enum class OrderWait : uint8_t {
+    RESPONSE,   // first response: ACK, REJECT, FILL or CLOSE
+    DONE,       // filled, closed or rejected
+};
+
 // ── OEClient ─────────────────────────────────────────────────────────────────
 //
 // TCP order-entry client.  Implements IOrderSender so a RiskManager can use
@@ -23,6 +89,15 @@ struct FillEvent {
 // Callbacks are invoked synchronously inside wait_for_response() and allow
 // an external RiskManager (or strategy) to track fills, rejects, and closes
 // without polling.
+//
+// Async mode (start_async(), after login): a reader thread owns the socket's
+// receive side, decodes every response and pushes it onto an SPSC queue.
+// Sends return as soon as the request is written — true means sent, not
+// acknowledged. The strategy thread drains the queue with dispatch_events(),
+// which keeps the open-order set and runs the callbacks on that thread.
+// wait_for_response() and wait_for_fill() still work: they drain the queue
+// instead of reading the socket. Everything except the reader thread's own
+// work must stay on the one strategy thread.
 
 class OEClient : public IOrderSender {
 public:
@@ -50,6 +125,63 @@ public:
     // Cancel every order that has been ACK'd and not yet fully filled/closed.
     void cancel_all_open_orders();
 
+    // ── Completion handles ───────────────────────────────────────────────────
+    // submit_new_order() sends without waiting and returns a handle whose
+    // table entry is kept until release(). wait_all() / wait_any() consume
+    // responses — from the queue when async, the socket otherwise — until
+    // their handles are satisfied or `deadline` passes, applying every
+    // response on the way like dispatch_events(). A multi-leg send can
+    // then be collected in one round trip whatever order the ACKs come in.
+
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    OrderHandle submit_new_order(uint64_t order_id, uint32_t symbol, SIDE side,
+                                 uint32_t qty, int32_t price);
+
+    // Table entry for an order, nullptr if it is unknown or was dropped
+    const OrderState* order_state(uint64_t order_id) const { return orders_.find(order_id); }
+    const OrderState* order_state(OrderHandle h)     const { return orders_.find(h.order_id); }
+
+    // True once every handle is satisfied; false at the deadline or on a
+    // disconnect
+    bool wait_all(const OrderHandle* handles, size_t count, OrderWait until, Deadline deadline);
+
+    // Index of a satisfied handle (the lowest if several are); -1 at the
+    // deadline or on a disconnect
+    int  wait_any(const OrderHandle* handles, size_t count, OrderWait until, Deadline deadline);
+
+    // Done with the handle: its entry goes once the order is done
+    void release(OrderHandle h);
+
+    // Orders in the table, done-but-unreleased ones included
+    size_t open_order_count() const { return orders_.size(); }
+
+    // ── Burst send ───────────────────────────────────────────────────────────
+    // Encode `count` new orders back to back and write them with one send(),
+    // so every leg of a basket reaches the exchange in one segment (the
+    // socket is TCP_NODELAY). Past BURST_MAX the orders go out in chunks,
+    // all but the last flagged MSG_MORE so the kernel holds them for a
+    // single flush. handles[i] is as from submit_new_order(orders[i]...).
+    // False if a write fails: every order not fully sent is then already
+    // REJECTED (reason NONE), so waits on its handle return at once.
+    static constexpr size_t BURST_MAX = 32;
+    bool submit_burst(const OrderRequest* orders, size_t count, OrderHandle* handles);
+
+    // ── Async mode ───────────────────────────────────────────────────────────
+    // Start the reader thread. `on_ready` (optional) runs on the reader
+    // thread after each batch of events is queued, e.g. to wake a strategy
+    // parked on SymbolManager::wait_for_change(). False if not logged in.
+    bool start_async(std::function<void()> on_ready = {});
+    void stop_async();
+    bool is_async() const { return async_; }
+
+    // Strategy thread: take one queued event without acting on it
+    bool poll_event(OeEvent& ev) { return events_.try_pop(ev); }
+
+    // Strategy thread: apply every queued event — open-order set and
+    // callbacks — and return how many there were
+    size_t dispatch_events();
+
     // ── Response callbacks ───────────────────────────────────────────────────
     using FillCb   = std::function<void(const FillEvent&)>;
     using RejectCb = std::function<void(uint64_t order_id)>;
@@ -69,16 +201,57 @@ private:
     uint32_t    seq_num_;
     uint32_t    client_id_;
 
-    // Orders that have been ACK'd but not yet fully filled or closed.
-    std::unordered_set<uint64_t> live_orders_;
+    // Open-order table: order id → state, for every order not yet done
+    // (and done ones with a handle out). Strategy thread only.
+    FlatHashMap<OrderState> orders_{256};
+    bool                    connected_ = true;
+
+    // Async mode
+    static constexpr size_t EVENT_QUEUE_DEPTH = 4096;
+    SpscQueue<OeEvent, EVENT_QUEUE_DEPTH> events_;
+    std::thread                           reader_;
+    std::atomic<bool>                     reader_stop_{false};
+    std::function<void()>                 on_ready_;
+    bool                                  async_ = false;
+
+    // Session log: lines gather in log_buf_ (under log_mutex_) and go to
+    // oe_log.txt a buffer at a time; log_out_ is the buffer being written
+    static constexpr size_t LOG_FLUSH_BYTES = 64 * 1024;
+    std::mutex                            log_mutex_;   // reader and sender both log
+    std::string                           log_buf_;
+    std::string                           log_out_;
 
     FillCb   on_fill_cb_;
     RejectCb on_reject_cb_;
     CloseCb  on_close_cb_;
 
+    // Response stream: buffered reads, frames handed out in place. Read by
+    // the reader thread when async, by the strategy thread otherwise.
+    OeFrameReader rx_;
+
+    // Wire templates, rebuilt at login with the session's ids
+    OrderTemplates templates_;
+
+    // Burst encode buffer, reused across bursts
+    std::array<ndfex::oe::new_order, BURST_MAX> burst_buf_;
+
     void send_raw(const void* data, size_t len);
-    bool read_response(char* buf, size_t& len);
+    bool send_all(const void* data, size_t len, int flags);
+    ndfex::oe::new_order& stage_new_order(uint64_t order_id, uint32_t symbol,
+                                          SIDE side, uint32_t qty, int32_t price);
+    const char* read_response(size_t& len);
+    const char* take_frame(size_t& len);
+
+    static bool decode_response(const char* buf, OeEvent& ev);
+    void reader_loop();
+    void track(const OeEvent& ev);
+    void apply_event(const OeEvent& ev);
+    bool next_event(Deadline deadline);
+    bool satisfied(uint64_t order_id, OrderWait until) const;
+    bool await_event(uint64_t order_id, bool until_fill, std::chrono::milliseconds timeout);
     void log_message(const char* direction, const void* data, size_t len);
+    void log_append(const std::string& text);
+    void flush_log();
 };
 
 #endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "oe_messages.h"
+
+// ── OeFrameReader ─────────────────────────────────────────────────────────────
+//
+// Buffered decoder for the order-entry response stream. fill() makes one
+// recv() for as many bytes as the socket has and the buffer can take;
+// next() then hands out every complete oe_response_header-framed message
+// in it, as a pointer into the buffer — no copy, and one syscall for a
+// whole burst of ACKs and fills rather than two per message.
+//
+// A frame split across reads stays in the buffer until the rest arrives.
+// Once the read position passes the halfway mark, the partial tail (less
+// than one frame) is moved back to the front, so the free span that
+// recv() writes into is always contiguous.
+//
+// A header whose length is shorter than the header or longer than
+// MAX_FRAME cannot be resynchronised: next() stops and malformed() is set.
+//
+// Single-threaded. A frame from next() is valid until the next fill().
+
+class OeFrameReader {
+public:
+    static constexpr size_t CAPACITY  = 64 * 1024;
+    static constexpr size_t MAX_FRAME = 256;
+
+    // One recv() into the free space. Bytes read; 0 on orderly close;
+    // -1 on error (errno set — EAGAIN/EWOULDBLOCK for an empty
+    // non-blocking read, EINTR if interrupted, ENOBUFS if the buffer is
+    // full of frames nobody has taken).
+    ssize_t fill(int fd, int flags = 0) {
+        compact();
+        if (end_ == CAPACITY) { errno = ENOBUFS; return -1; }   // next() first
+        ssize_t n = recv(fd, buf_ + end_, CAPACITY - end_, flags);
+        if (n > 0) end_ += static_cast<size_t>(n);
+        return n;
+    }
+
+    // Next complete frame, or nullptr if the buffer holds only part of one
+    const char* next(size_t& len) {
+        size_t avail = end_ - begin_;
+        if (avail < sizeof(ndfex::oe::oe_response_header)) return nullptr;
+
+        uint16_t frame_len;
+        std::memcpy(&frame_len, buf_ + begin_, sizeof(frame_len));
+        if (frame_len < sizeof(ndfex::oe::oe_response_header) || frame_len > MAX_FRAME) {
+            malformed_ = true;
+            return nullptr;
+        }
+        if (avail < frame_len) return nullptr;
+
+        const char* frame = buf_ + begin_;
+        begin_ += frame_len;
+        len = frame_len;
+        return frame;
+    }
+
+    bool   malformed() const { return malformed_; }
+    size_t buffered()  const { return end_ - begin_; }
+    void   reset()           { begin_ = end_ = 0; malformed_ = false; }
+
+private:
+    alignas(64) char buf_[CAPACITY];
+    size_t begin_     = 0;    // first unconsumed byte
+    size_t end_       = 0;    // one past the last received byte
+    bool   malformed_ = false;
+
+    void compact() {
+        if (begin_ == end_) { begin_ = end_ = 0; return; }
+        if (begin_ < CAPACITY / 2) return;
+        std::memmove(buf_, buf_ + begin_, end_ - begin_);
+        end_  -= begin_;
+        begin_ = 0;
+    }
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "oe_messages.h"
+
+// ── OeStubExchange ────────────────────────────────────────────────────────────
+//
+// Local TCP stand-in for the order-entry gateway, for tests and benchmarks.
+// Listens on 127.0.0.1 at an ephemeral port and serves one session:
+//   LOGIN        → login_response SUCCESS, session SESSION_ID
+//   NEW_ORDER    → ACK, then (fill_orders) one closing FILL at the order price;
+//                  REJECT INVALID_QUANTITY if the quantity is zero
+//                  With fills_per_order > 1 the ACK is followed by a stream
+//                  of that many 1-lot FILLs, the last one closing, written
+//                  in large batches: a fill firehose for read benchmarks.
+//   MODIFY_ORDER → ACK
+//   DELETE_ORDER → CLOSE
+// Every reply waits `response_delay` first, to stand in for the round trip.
+
+class OeStubExchange {
+public:
+    static constexpr uint64_t SESSION_ID = 77;
+
+    std::atomic<bool>         fill_orders{true};
+    std::chrono::microseconds response_delay{0};   // set before start()
+    uint32_t                  fills_per_order = 1;  // set before start()
+
+    std::atomic<uint32_t> orders_seen{0};
+
+    OeStubExchange() {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port        = 0;
+        bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        listen(listen_fd_, 1);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+    }
+
+    ~OeStubExchange() {
+        stop();
+        if (listen_fd_ >= 0) close(listen_fd_);
+    }
+
+    int port() const { return port_; }
+
+    // Serve one connection on a background thread
+    void start() {
+        thread_ = std::thread([this]() { serve(); });
+    }
+
+    // Drop the session (the client sees a disconnect) and join
+    void stop() {
+        int conn = conn_fd_.load();
+        if (conn >= 0) shutdown(conn, SHUT_RDWR);
+        else if (listen_fd_ >= 0) shutdown(listen_fd_, SHUT_RDWR);
+        if (thread_.joinable()) thread_.join();
+        conn = conn_fd_.exchange(-1);
+        if (conn >= 0) close(conn);
+    }
+
+private:
+    int              listen_fd_ = -1;
+    std::atomic<int> conn_fd_{-1};
+    int              port_      = 0;
+    uint32_t         seq_       = 0;
+    std::thread      thread_;
+
+    bool read_exact(void* buf, size_t len) {
+        size_t got = 0;
+        while (got < len) {
+            ssize_t n = recv(conn_fd_, static_cast<char*>(buf) + got, len - got, 0);
+            if (n <= 0) return false;
+            got += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    template <typename Msg>
+    void stamp(Msg& m, ndfex::oe::MSG_TYPE type) {
+        m.header.length   = sizeof(Msg);
+        m.header.msg_type = static_cast<uint8_t>(type);
+        m.header.version  = ndfex::oe::OE_PROTOCOL_VERSION;
+        m.header.seq_num  = ++seq_;
+    }
+
+    template <typename Msg>
+    void reply(Msg& m, ndfex::oe::MSG_TYPE type) {
+        stamp(m, type);
+        if (response_delay.count()) std::this_thread::sleep_for(response_delay);
+        send(conn_fd_, &m, sizeof(Msg), MSG_NOSIGNAL);
+    }
+
+    bool send_all(const void* data, size_t len) {
+        const char* p = static_cast<const char*>(data);
+        while (len > 0) {
+            ssize_t n = send(conn_fd_, p, len, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            p   += n;
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // fills_per_order 1-lot fills, BATCH to a send
+    void stream_fills(uint64_t order_id, int32_t price) {
+        namespace oe = ndfex::oe;
+        constexpr uint32_t BATCH = 2048;
+        static thread_local oe::order_fill batch[BATCH];
+        for (uint32_t sent = 0; sent < fills_per_order; ) {
+            uint32_t n = std::min(BATCH, fills_per_order - sent);
+            for (uint32_t i = 0; i < n; ++i) {
+                oe::order_fill& f = batch[i];
+                stamp(f, oe::MSG_TYPE::FILL);
+                f.order_id = order_id;
+                f.quantity = 1;
+                f.price    = price;
+                f.flags    = static_cast<uint8_t>(sent + i + 1 == fills_per_order
+                                                  ? oe::FILL_FLAGS::CLOSED : oe::FILL_FLAGS::PARTIAL_FILL);
+            }
+            if (!send_all(batch, n * sizeof(oe::order_fill))) return;
+            sent += n;
+        }
+    }
+
+    void serve() {
+        namespace oe = ndfex::oe;
+        int conn = accept(listen_fd_, nullptr, nullptr);
+        if (conn < 0) return;
+        conn_fd_.store(conn);
+
+        char buf[256];
+        while (true) {
+            auto* hdr = reinterpret_cast<oe::oe_request_header*>(buf);
+            if (!read_exact(hdr, sizeof(*hdr))) return;
+            if (hdr->length < sizeof(*hdr) || hdr->length > sizeof(buf)) return;
+            if (!read_exact(buf + sizeof(*hdr), hdr->length - sizeof(*hdr))) return;
+
+            switch (static_cast<oe::MSG_TYPE>(hdr->msg_type)) {
+            case oe::MSG_TYPE::LOGIN: {
+                oe::login_response r{};
+                r.session_id = SESSION_ID;
+                r.status     = static_cast<uint8_t>(oe::LOGIN_STATUS::SUCCESS);
+                reply(r, oe::MSG_TYPE::LOGIN_RESPONSE);
+                break;
+            }
+            case oe::MSG_TYPE::NEW_ORDER: {
+                auto* o = reinterpret_cast<oe::new_order*>(buf);
+                orders_seen.fetch_add(1, std::memory_order_relaxed);
+                if (o->quantity == 0) {
+                    oe::order_reject r{};
+                    r.order_id      = o->order_id;
+                    r.reject_reason = static_cast<uint8_t>(oe::REJECT_REASON::INVALID_QUANTITY);
+                    reply(r, oe::MSG_TYPE::REJECT);
+                    break;
+                }
+                oe::order_ack a{};
+                a.order_id      = o->order_id;
+                a.exch_order_id = o->order_id + 1'000'000;
+                a.quantity      = o->quantity;
+                a.price         = o->price;
+                reply(a, oe::MSG_TYPE::ACK);
+                if (fill_orders && fills_per_order > 1) {
+                    stream_fills(o->order_id, o->price);
+                } else if (fill_orders) {
+                    oe::order_fill f{};
+                    f.order_id = o->order_id;
+                    f.quantity = o->quantity;
+                    f.price    = o->price;
+                    f.flags    = static_cast<uint8_t>(oe::FILL_FLAGS::CLOSED);
+                    reply(f, oe::MSG_TYPE::FILL);
+                }
+                break;
+            }
+            case oe::MSG_TYPE::MODIFY_ORDER: {
+                auto* m = reinterpret_cast<oe::modify_order*>(buf);
+                oe::order_ack a{};
+                a.order_id = m->order_id;
+                a.quantity = m->quantity;
+                a.price    = m->price;
+                reply(a, oe::MSG_TYPE::ACK);
+                break;
+            }
+            case oe::MSG_TYPE::DELETE_ORDER: {
+                auto* d = reinterpret_cast<oe::delete_order*>(buf);
+                oe::order_closed c{};
+                c.order_id = d->order_id;
+                reply(c, oe::MSG_TYPE::CLOSE);
+                break;
+            }
+            default:
+                return;
+            }
+        }
+    }
+};
@@ -0,0 +1,58 @@
+#include "order_router.h"
+
+OrderRouter::OrderRouter(size_t expected_orders) : entries_(expected_orders) {
+    for (auto& ids : by_symbol_)
+        ids.reserve(expected_orders / MAX_SYMBOL);
+}
+
+// ── Updates ───────────────────────────────────────────────────────────────────
+
+void OrderRouter::add(uint64_t order_id, uint32_t symbol) {
+    if (symbol == NO_SYMBOL || symbol > MAX_SYMBOL) return;
+
+    if (const Entry* e = entries_.find(order_id)) {
+        if (e->symbol == symbol) return;
+        unlink(*e);
+        entries_.erase(order_id);
+    }
+
+    auto& ids = by_symbol_[symbol];
+    entries_.insert(order_id, Entry{symbol, static_cast<uint32_t>(ids.size())});
+    ids.push_back(order_id);
+}
+
+void OrderRouter::erase(uint64_t order_id) {
+    const Entry* e = entries_.find(order_id);
+    if (!e) return;
+    unlink(*e);
+    entries_.erase(order_id);
+}
+
+void OrderRouter::drop_symbol(uint32_t symbol) {
+    if (symbol == NO_SYMBOL || symbol > MAX_SYMBOL) return;
+    auto& ids = by_symbol_[symbol];
+    for (uint64_t oid : ids) entries_.erase(oid);
+    ids.clear();   // keeps capacity for the snapshot reload
+}
+
+// Swap the last id of the symbol's list into e's position.
+// Takes e by value: it usually points into entries_.
+void OrderRouter::unlink(Entry e) {
+    auto& ids = by_symbol_[e.symbol];
+    uint64_t moved = ids.back();
+    ids[e.index]   = moved;
+    ids.pop_back();
+    if (e.index < ids.size()) entries_.find(moved)->index = e.index;
+}
+
+// ── Lookups ───────────────────────────────────────────────────────────────────
+
+uint32_t OrderRouter::find(uint64_t order_id) const {
+    const Entry* e = entries_.find(order_id);
+    return e ? e->symbol : NO_SYMBOL;
+}
+
+size_t OrderRouter::symbol_size(uint32_t symbol) const {
+    if (symbol == NO_SYMBOL || symbol > MAX_SYMBOL) return 0;
+    return by_symbol_[symbol].size();
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "flat_hash_map.h"
+#include "symbol_config.h"
+
+// ── OrderRouter ───────────────────────────────────────────────────────────────
+//
+// order_id → symbol_id routing for delete / modify / trade messages, which
+// carry no symbol on the wire.
+//
+// Alongside the id map, every symbol keeps a dense list of its live order
+// ids, and each map entry remembers its position in that list. Removing one
+// order is a swap-with-last, and dropping a symbol on snapshot walks only
+// that symbol's list — O(orders in symbol), not O(all orders).
+//
+// Market data thread only. Symbol ids outside [1, MAX_SYMBOL] are ignored.
+
+class OrderRouter {
+public:
+    static constexpr uint32_t MAX_SYMBOL = MAX_SYMBOLS - 1;
+    static constexpr uint32_t NO_SYMBOL  = 0;
+
+    explicit OrderRouter(size_t expected_orders = 100000);
+
+    // Record that `order_id` rests on `symbol` (re-homes a known id)
+    void     add(uint64_t order_id, uint32_t symbol);
+
+    // Symbol the order belongs to, or NO_SYMBOL if unknown
+    uint32_t find(uint64_t order_id) const;
+
+    void     erase(uint64_t order_id);
+
+    // Forget every order on `symbol` — called before loading its snapshot
+    void     drop_symbol(uint32_t symbol);
+
+    size_t   size()                     const { return entries_.size(); }
+    size_t   symbol_size(uint32_t symbol) const;
+
+private:
+    struct Entry {
+        uint32_t symbol;
+        uint32_t index;   // position in by_symbol_[symbol]
+    };
+
+    FlatHashMap<Entry>                                entries_;
+    std::array<std::vector<uint64_t>, MAX_SYMBOL + 1> by_symbol_;  // index 0 unused
+
+    void unlink(Entry e);
+};
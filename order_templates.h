@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "oe_messages.h"
+#include "symbol_config.h"
+
+// ── OrderTemplates ────────────────────────────────────────────────────────────
+//
+// Prebuilt order-entry requests. build() fills in every field that is fixed
+// for the session — length, type, version, client_id, session_id, and for a
+// new order the symbol and side — once, at login. A send then patches the
+// fields that change per order (seq_num, order_id, quantity, price) in place
+// and hands the template itself to send(): no zeroing, no header assembly
+// and no copy.
+//
+// Each template sits alone on a cache line, so a patch touches one line and
+// the templates for the symbols being traded stay hot together.
+//
+// A patched template stays valid until the next patch of the same template;
+// send it (or copy it out) before patching again. A new order for a symbol
+// outside 1..MAX_SYMBOLS-1 or an unknown side is built in a spare slot.
+
+class OrderTemplates {
+public:
+    void build(uint32_t client_id, uint64_t session_id) {
+        for (uint32_t sym = 0; sym < MAX_SYMBOLS; ++sym)
+            for (int s = 0; s < 2; ++s) {
+                auto& m = new_order_[sym][s].msg;
+                std::memset(&m, 0, sizeof(m));
+                fill_header(m.header, sizeof(m), ndfex::oe::MSG_TYPE::NEW_ORDER, client_id, session_id);
+                m.symbol = sym;
+                m.side   = s == 0 ? SIDE::BUY : SIDE::SELL;
+            }
+        spare_new_ = new_order_[0][0];
+
+        std::memset(&delete_.msg, 0, sizeof(delete_.msg));
+        fill_header(delete_.msg.header, sizeof(delete_.msg), ndfex::oe::MSG_TYPE::DELETE_ORDER,
+                    client_id, session_id);
+
+        std::memset(&modify_.msg, 0, sizeof(modify_.msg));
+        fill_header(modify_.msg.header, sizeof(modify_.msg), ndfex::oe::MSG_TYPE::MODIFY_ORDER,
+                    client_id, session_id);
+    }
+
+    ndfex::oe::new_order& new_order(uint32_t seq_num, uint64_t order_id, uint32_t symbol,
+                                    SIDE side, uint32_t qty, int32_t price) {
+        auto& m = slot(symbol, side);
+        m.header.seq_num = seq_num;
+        m.order_id       = order_id;
+        m.quantity       = qty;
+        m.price          = price;
+        return m;
+    }
+
+    ndfex::oe::delete_order& delete_order(uint32_t seq_num, uint64_t order_id) {
+        auto& m = delete_.msg;
+        m.header.seq_num = seq_num;
+        m.order_id       = order_id;
+        return m;
+    }
+
+    ndfex::oe::modify_order& modify_order(uint32_t seq_num, uint64_t order_id, SIDE side,
+                                          uint32_t qty, int32_t price) {
+        auto& m = modify_.msg;
+        m.header.seq_num = seq_num;
+        m.order_id       = order_id;
+        m.side           = side;
+        m.quantity       = qty;
+        m.price          = price;
+        return m;
+    }
+
+private:
+    template <typename Msg>
+    struct alignas(64) Line { Msg msg; };
+
+    static_assert(sizeof(ndfex::oe::new_order) <= 64, "new_order template must fit one cache line");
+
+    std::array<std::array<Line<ndfex::oe::new_order>, 2>, MAX_SYMBOLS> new_order_;  // [symbol][side]
+    Line<ndfex::oe::new_order>    spare_new_;
+    Line<ndfex::oe::delete_order> delete_;
+    Line<ndfex::oe::modify_order> modify_;
+
+    static void fill_header(ndfex::oe::oe_request_header& h, size_t len, ndfex::oe::MSG_TYPE type,
+                            uint32_t client_id, uint64_t session_id) {
+        h.length     = static_cast<uint16_t>(len);
+        h.msg_type   = static_cast<uint8_t>(type);
+        h.version    = ndfex::oe::OE_PROTOCOL_VERSION;
+        h.client_id  = client_id;
+        h.session_id = session_id;
+    }
+
+    ndfex::oe::new_order& slot(uint32_t symbol, SIDE side) {
+        if (symbol < MAX_SYMBOLS && (side == SIDE::BUY || side == SIDE::SELL))
+            return new_order_[symbol][side == SIDE::BUY ? 0 : 1].msg;
+        auto& m  = spare_new_.msg;
+        m.symbol = symbol;
+        m.side   = side;
+        return m;
+    }
+};
@@ -1,35 +1,38 @@
 #include "orderbook.h"
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
-void OrderBook::handle_new_order(const new_order* msg) {
-    if (msg->header.msg_type != MSG_TYPE::NEW_ORDER) return;
-
+// Validation shared by live new orders and snapshot loads
+bool OrderBook::accept_new(const new_order* msg) {
      // Validate side
     if (msg->side != SIDE::BUY && msg->side != SIDE::SELL) {
-        std::cerr << "ERROR: Invalid side for order " << msg->order_id << "\n";
-        return;
+        note(Anomaly::INVALID_SIDE, msg->order_id, msg->price);
+        return false;
     }
     
     // Check for duplicate order
-    if (orders_.find(msg->order_id) != orders_.end()) {
-        std::cerr << "ERROR: Duplicate order ID " << msg->order_id << std::endl;
-        //throw std::runtime_error("Duplicate order ID");
-        return;
+    if (find_order(msg->order_id)) {
+        note(Anomaly::DUPLICATE_ID, msg->order_id, msg->price);
+        return false;
     }
     
     // Validate price and quantity
     if (msg->quantity == 0) {
-        std::cerr << "ERROR: Zero quantity order" << std::endl;
-        //throw std::runtime_error("Zero quantity");
-        return;
+        note(Anomaly::ZERO_QTY, msg->order_id, msg->price);
+        return false;
     }
     
     if (msg->price < 0) {
-        std::cerr << "ERROR: Negative price" << std::endl;
-        //throw std::runtime_error("Negative price");
-        return;
+        note(Anomaly::NEGATIVE_PRICE, msg->order_id, msg->price);
+        return false;
     }
+    return true;
+}
+
+bool OrderBook::handle_new_order(const new_order* msg) {
+    if (msg->header.msg_type != MSG_TYPE::NEW_ORDER) return false;
+    if (!accept_new(msg)) return false;
     
     // Store order info
     OrderInfo info;
@@ -38,48 +41,45 @@ void OrderBook::handle_new_order(const new_order* msg) {
     info.side = msg->side;
     info.symbol = msg->symbol;
     
-    orders_[msg->order_id] = info;
+    insert_order(msg->order_id, info);
     add_to_price_level(msg->side, msg->price, msg->quantity);
     
     // Update last sequence number
     last_seq_num_ = msg->header.seq_num;
     
     // Check for crossed book
-    if (is_crossed()) {
-        std::cerr << "ERROR: Book is crossed after new order!" << std::endl;
-        print_book();
-        //throw std::runtime_error("Crossed book");
-    }
+    if (is_crossed()) note(Anomaly::CROSSED, msg->order_id, msg->price);
+    return true;
 }
 
 void OrderBook::handle_delete_order(const delete_order* msg) {
-    auto it = orders_.find(msg->order_id);
-    if (it == orders_.end()) {
+    const OrderInfo* found = find_order(msg->order_id);
+    if (!found) {
         // Order not found - might have been fully traded
         return;
     }
     
-    const OrderInfo& info = it->second;
+    const OrderInfo info = *found;
     
     // Only process if this order belongs to our symbol
     if (info.symbol != symbol_) {
         return;
     }
     
-    remove_from_price_level(info.side, info.price, info.quantity);
-    orders_.erase(it);
+    remove_from_price_level(info.side, info.price, info.quantity, msg->order_id);
+    erase_order(msg->order_id);
     
     last_seq_num_ = msg->header.seq_num;
 }
 
 void OrderBook::handle_modify_order(const modify_order* msg) {
-    auto it = orders_.find(msg->order_id);
-    if (it == orders_.end()) {
-        std::cerr << "WARNING: Modifying non-existent order " << msg->order_id << std::endl;
+    OrderInfo* found = find_order(msg->order_id);
+    if (!found) {
+        note(Anomaly::UNKNOWN_ORDER, msg->order_id, msg->price);
         return;
     }
     
-    OrderInfo& info = it->second;
+    OrderInfo& info = *found;
     
     // Only process if this order belongs to our symbol
     if (info.symbol != symbol_) {
@@ -87,135 +87,292 @@ void OrderBook::handle_modify_order(const modify_order* msg) {
     }
     
     // Remove old quantity from price level
-    remove_from_price_level(info.side, info.price, info.quantity);
+    remove_from_price_level(info.side, info.price, info.quantity, msg->order_id);
     
     // Update order info
+    SIDE     old_side  = info.side;
+    int32_t  old_price = info.price;
+    uint32_t old_qty   = info.quantity;
     info.price = msg->price;
     info.quantity = msg->quantity;
     info.side = msg->side;
     
     // Add new quantity to (possibly new) price level
     add_to_price_level(info.side, info.price, info.quantity);
+    requeue_order(msg->order_id, old_side, old_price, old_qty);
     
     last_seq_num_ = msg->header.seq_num;
     
-    if (is_crossed()) {
-        std::cerr << "ERROR: Book crossed after modify!" << std::endl;
-        //throw std::runtime_error("Crossed book");
-    }
+    if (is_crossed()) note(Anomaly::CROSSED, msg->order_id, msg->price);
 }
 
-void OrderBook::handle_trade(const trade* msg) {
-    auto it = orders_.find(msg->order_id);
-    if (it == orders_.end()) {
+bool OrderBook::handle_trade(const trade* msg) {
+    OrderInfo* found = find_order(msg->order_id);
+    if (!found) {
         // Order might have been deleted or fully traded already
-        return;
+        return false;
     }
     
-    OrderInfo& info = it->second;
+    OrderInfo& info = *found;
     
     // Only process if this order belongs to our symbol
     if (info.symbol != symbol_) {
-        return;
+        return false;
     }
     
     if (msg->quantity > info.quantity) {
-        std::cerr << "ERROR: Trade quantity " << msg->quantity 
-                  << " exceeds order quantity " << info.quantity << "!" << std::endl;
-        //throw std::runtime_error("Invalid trade quantity");
-        remove_from_price_level(info.side, info.price, info.quantity);
-        orders_.erase(it);
-        return; 
+        note(Anomaly::OVER_TRADE, msg->order_id, info.price);
+        remove_from_price_level(info.side, info.price, info.quantity, msg->order_id);
+        erase_order(msg->order_id);
+        return false; 
     }
     
     // Reduce quantity at price level
-    remove_from_price_level(info.side, info.price, msg->quantity);
+    remove_from_price_level(info.side, info.price, msg->quantity, msg->order_id);
     info.quantity -= msg->quantity;
     
     // If fully executed, remove order
-    if (info.quantity == 0) {
-        orders_.erase(it);
+    bool resting = info.quantity != 0;
+    if (!resting) {
+        erase_order(msg->order_id);
     }
     
     last_seq_num_ = msg->header.seq_num;
+    return resting;
+}
+
+// ── Reset and snapshot load ───────────────────────────────────────────────────
+
+void OrderBook::clear() {
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+    orders_.for_each([&](uint64_t, OrderNode*& n) { pool_.release(n); });
+    bid_queues_.clear();
+    ask_queues_.clear();
+#endif
+    orders_.clear();
+    bids_.clear();
+    asks_.clear();
+    last_seq_num_ = 0;
+}
+
+void OrderBook::load_snapshot(const new_order* const* orders, size_t count) {
+    orders_.reserve(orders_.size() + count);
+
+    // Insert in snapshot order, so duplicates resolve as in a replay and
+    // each level's queue keeps snapshot (time) order
+    load_orders_.clear();
+    for (size_t i = 0; i < count; ++i) {
+        const new_order* msg = orders[i];
+        if (!accept_new(msg)) continue;
+        insert_order(msg->order_id, OrderInfo{msg->price, msg->quantity, msg->side, msg->symbol});
+        load_orders_.push_back(msg);
+    }
+
+    // Then aggregate levels: bids first, then asks, each by ascending price
+    std::sort(load_orders_.begin(), load_orders_.end(),
+              [](const new_order* a, const new_order* b) {
+        if (a->side != b->side) return a->side < b->side;
+        return a->price < b->price;
+    });
+    auto first = load_orders_.data();
+    auto last  = first + load_orders_.size();
+    auto split = std::partition_point(first, last, [](const new_order* o) {
+        return o->side == SIDE::BUY;
+    });
+    load_side(bids_, first, split);
+    load_side(asks_, split, last);
+
+    if (is_crossed()) note(Anomaly::CROSSED, 0, bids_.best_price());
+}
+
+// Sum one side's price-sorted orders into levels and load its ladder
+void OrderBook::load_side(PriceLadder& ladder, const new_order* const* first,
+                          const new_order* const* last) {
+    load_levels_.clear();
+    for (auto it = first; it != last; ++it) {
+        const new_order* msg = *it;
+        if (!load_levels_.empty() && load_levels_.back().first == msg->price)
+            load_levels_.back().second += msg->quantity;
+        else
+            load_levels_.emplace_back(msg->price, msg->quantity);
+    }
+    if (ladder.empty()) {
+        ladder.load(load_levels_.data(), load_levels_.size());
+    } else {
+        for (auto& [px, q] : load_levels_) ladder.add(px, q);
+    }
 }
 
 int32_t OrderBook::get_best_bid_price() const {
-    return bids_.empty() ? 0 : bids_.begin()->first;
+    return bids_.best_price();
 }
 
 uint32_t OrderBook::get_best_bid_qty() const {
-    return bids_.empty() ? 0 : bids_.begin()->second;
+    return bids_.best_qty();
 }
 
 int32_t OrderBook::get_best_ask_price() const {
-    return asks_.empty() ? 0 : asks_.begin()->first;
+    return asks_.best_price();
 }
 
 uint32_t OrderBook::get_best_ask_qty() const {
-    return asks_.empty() ? 0 : asks_.begin()->second;
+    return asks_.best_qty();
 }
 
 void OrderBook::add_to_price_level(SIDE side, int32_t price, uint32_t quantity) {
     if (side == SIDE::BUY) {
-        bids_[price] += quantity;
+        bids_.add(price, quantity);
     } else {
-        asks_[price] += quantity;
+        asks_.add(price, quantity);
     }
 }
 
-void OrderBook::remove_from_price_level(SIDE side, int32_t price, uint32_t quantity) {
-    if (side == SIDE::BUY) {
-        auto it = bids_.find(price);
-        if (it != bids_.end()) {
-            if (it->second < quantity) {
-                std::cerr << "ERROR: Removing more quantity (" << quantity 
-                          << ") than exists (" << it->second << ") at bid price level " 
-                          << price << std::endl;
-                //throw std::runtime_error("Invalid quantity removal");
-                bids_.erase(it); 
-                return;
-            }
-            it->second -= quantity;
-            if (it->second == 0) {
-                bids_.erase(it);
-            }
-        }
-    } else {
-        auto it = asks_.find(price);
-        if (it != asks_.end()) {
-            if (it->second < quantity) {
-                std::cerr << "ERROR: Removing more quantity (" << quantity 
-                          << ") than exists (" << it->second << ") at ask price level " 
-                          << price << std::endl;
-                //throw std::runtime_error("Invalid quantity removal");
-                asks_.erase(it);
-                return;
-            }
-            it->second -= quantity;
-            if (it->second == 0) {
-                asks_.erase(it);
-            }
-        }
+void OrderBook::remove_from_price_level(SIDE side, int32_t price, uint32_t quantity,
+                                        uint64_t order_id) {
+    PriceLadder& ladder = side == SIDE::BUY ? bids_ : asks_;
+    uint32_t level_qty  = ladder.qty_at(price);
+    if (level_qty == 0) return;
+
+    if (level_qty < quantity) {
+        note(Anomaly::OVER_REMOVAL, order_id, price);
+        ladder.erase_level(price);
+        return;
     }
+    ladder.remove(price, quantity);
 }
 
 bool OrderBook::is_crossed() const {
     if (bids_.empty() || asks_.empty()) return false;
-    return bids_.begin()->first >= asks_.begin()->first;
+    return bids_.best_price() >= asks_.best_price();
 }
 
 void OrderBook::print_book() const {
+    auto asks = asks_.levels();
     std::cout << "\n=== Order Book (Symbol " << symbol_ << ") ===" << std::endl;
     std::cout << "ASKS:" << std::endl;
-    for (auto it = asks_.rbegin(); it != asks_.rend(); ++it) {
+    for (auto it = asks.rbegin(); it != asks.rend(); ++it) {
         std::cout << "  " << it->first << " @ " << it->second << std::endl;
     }
     std::cout << "---" << std::endl;
-    for (const auto& bid : bids_) {
+    for (const auto& bid : bids_.levels()) {
         std::cout << "  " << bid.first << " @ " << bid.second << std::endl;
     }
     std::cout << "BIDS:" << std::endl;
     std::cout << "Best Bid: " << get_best_bid_price() << " @ " << get_best_bid_qty() << std::endl;
     std::cout << "Best Ask: " << get_best_ask_price() << " @ " << get_best_ask_qty() << std::endl;
-}
\ No newline at end of file
+}
+
+// ── Anomaly counters ──────────────────────────────────────────────────────────
+
+const char* anomaly_name(Anomaly a) {
+    switch (a) {
+        case Anomaly::INVALID_SIDE:   return "invalid_side";
+        case Anomaly::DUPLICATE_ID:   return "duplicate_id";
+        case Anomaly::ZERO_QTY:       return "zero_qty";
+        case Anomaly::NEGATIVE_PRICE: return "negative_price";
+        case Anomaly::CROSSED:        return "crossed";
+        case Anomaly::OVER_REMOVAL:   return "over_removal";
+        case Anomaly::OVER_TRADE:     return "over_trade";
+        case Anomaly::UNKNOWN_ORDER:  return "unknown_order";
+        default:                      return "?";
+    }
+}
+
+uint64_t BookAnomalies::total() const {
+    uint64_t sum = 0;
+    for (const auto& c : counts) sum += c.load(std::memory_order_relaxed);
+    return sum;
+}
+
+void BookAnomalies::print(std::ostream& os, uint32_t symbol) const {
+    os << "[Book] sym=" << symbol;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        uint64_t n = counts[i].load(std::memory_order_relaxed);
+        if (n) os << " " << anomaly_name(static_cast<Anomaly>(i)) << "=" << n;
+    }
+    os << " | last: " << anomaly_name(static_cast<Anomaly>(last_kind.load(std::memory_order_relaxed)))
+       << " order=" << last_order_id.load(std::memory_order_relaxed)
+       << " px="    << last_price.load(std::memory_order_relaxed) << "\n";
+}
+
+// ── Order-by-order storage ────────────────────────────────────────────────────
+
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+
+void OrderBook::insert_order(uint64_t order_id, const OrderInfo& info) {
+    OrderNode* n = pool_.allocate(OrderNode{info, order_id, nullptr, nullptr});
+    orders_.insert(order_id, n);
+    link(n);
+}
+
+void OrderBook::erase_order(uint64_t order_id) {
+    OrderNode** found = orders_.find(order_id);
+    if (!found) return;
+    OrderNode* n = *found;
+    orders_.erase(order_id);
+    unlink(n);
+    pool_.release(n);
+}
+
+void OrderBook::requeue_order(uint64_t order_id, SIDE old_side,
+                              int32_t old_price, uint32_t old_qty) {
+    OrderNode** found = orders_.find(order_id);
+    if (!found) return;
+    OrderNode* n = *found;
+
+    bool keeps_priority = n->info.side == old_side
+                       && n->info.price == old_price
+                       && n->info.quantity <= old_qty;
+    if (keeps_priority) return;
+
+    // Unlink from the old level, then append at the back of the new one
+    OrderInfo now = n->info;
+    n->info.side  = old_side;
+    n->info.price = old_price;
+    unlink(n);
+    n->info = now;
+    link(n);
+}
+
+// Append at the tail of the order's price level
+void OrderBook::link(OrderNode* n) {
+    LevelQueue& q = queues(n->info.side)[static_cast<uint32_t>(n->info.price)];
+    n->prev = q.tail;
+    n->next = nullptr;
+    if (q.tail) q.tail->next = n;
+    else        q.head       = n;
+    q.tail = n;
+}
+
+void OrderBook::unlink(OrderNode* n) {
+    auto& qs = queues(n->info.side);
+    uint64_t key = static_cast<uint32_t>(n->info.price);
+    LevelQueue* q = qs.find(key);
+    if (!q) return;
+
+    if (n->prev) n->prev->next = n->next;
+    else         q->head       = n->next;
+    if (n->next) n->next->prev = n->prev;
+    else         q->tail       = n->prev;
+    n->prev = n->next = nullptr;
+
+    if (!q->head) qs.erase(key);
+}
+
+int64_t OrderBook::queue_ahead(uint64_t order_id) const {
+    OrderNode* const* found = orders_.find(order_id);
+    if (!found) return -1;
+    int64_t ahead = 0;
+    for (const OrderNode* p = (*found)->prev; p; p = p->prev)
+        ahead += p->info.quantity;
+    return ahead;
+}
+
+size_t OrderBook::orders_at_level(SIDE side, int32_t price) const {
+    const LevelQueue* q = queues(side).find(static_cast<uint32_t>(price));
+    size_t n = 0;
+    for (const OrderNode* p = q ? q->head : nullptr; p; p = p->next) ++n;
+    return n;
+}
+
+#endif
@@ -1,11 +1,23 @@
 #ifndef ORDERBOOK_H
 #define ORDERBOOK_H
 
-#include <map>
-#include <unordered_map>
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <iostream>
+#include <utility>
+#include <vector>
 #include "messages.h"
+#include "flat_hash_map.h"
+#include "price_ladder.h"
+
+// Build with -DORDERBOOK_ORDER_BY_ORDER (make BOOK=mbo) for the
+// order-by-order book: every order is a pool-allocated record linked into
+// a FIFO queue at its price level, which gives queue position. The default
+// level-aggregated book only keeps per-order info and level totals.
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+#include "object_pool.h"
+#endif
 
 struct OrderInfo {
     int32_t price;
@@ -14,16 +26,94 @@ struct OrderInfo {
     uint32_t symbol;
 };
 
+// ── BookAnomalies ────────────────────────────────────────────────────────────
+// Per-symbol counters for feed anomalies the book rejects or repairs.
+// Written by the market data thread with relaxed atomics (no logging on the
+// hot path); any thread may read them. The owner keeps one block per symbol
+// that outlives book resets, and prints it from a monitor thread.
+
+enum class Anomaly : uint8_t {
+    INVALID_SIDE,
+    DUPLICATE_ID,
+    ZERO_QTY,
+    NEGATIVE_PRICE,
+    CROSSED,          // book crossed after a new order or modify
+    OVER_REMOVAL,     // removing more than rests at a level
+    OVER_TRADE,       // trade larger than the order
+    UNKNOWN_ORDER,    // modify of an order not in the book
+    COUNT
+};
+
+const char* anomaly_name(Anomaly a);
+
+struct BookAnomalies {
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(Anomaly::COUNT)> counts{};
+
+    // Context of the most recent anomaly, for the diagnostic dump
+    std::atomic<uint8_t>  last_kind{0};
+    std::atomic<uint64_t> last_order_id{0};
+    std::atomic<int32_t>  last_price{0};
+
+    void record(Anomaly a, uint64_t order_id, int32_t price) {
+        counts[static_cast<size_t>(a)].fetch_add(1, std::memory_order_relaxed);
+        last_kind    .store(static_cast<uint8_t>(a), std::memory_order_relaxed);
+        last_order_id.store(order_id, std::memory_order_relaxed);
+        last_price   .store(price, std::memory_order_relaxed);
+    }
+
+    uint64_t count(Anomaly a) const {
+        return counts[static_cast<size_t>(a)].load(std::memory_order_relaxed);
+    }
+    uint64_t total() const;
+
+    // One line: non-zero counters and the last anomaly seen
+    void print(std::ostream& os, uint32_t symbol) const;
+};
+
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+// One resting order, linked into its price level's FIFO
+struct OrderNode {
+    OrderInfo  info;
+    uint64_t   order_id;
+    OrderNode* prev;
+    OrderNode* next;
+};
+
+struct LevelQueue {
+    OrderNode* head = nullptr;
+    OrderNode* tail = nullptr;
+};
+#endif
+
 class OrderBook {
 public:
-    OrderBook(uint32_t symbol_id) : symbol_(symbol_id), last_seq_num_(0) {
-        orders_.reserve(10000);  //Prevent reallocations
-    }
+    // tick: price increment of the symbol, used to index the level ladders
+    // anomalies: counter block to record into; null disables counting
+    OrderBook(uint32_t symbol_id, int32_t tick = 1, BookAnomalies* anomalies = nullptr)
+        : symbol_(symbol_id), last_seq_num_(0), anomalies_(anomalies),
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+          pool_(10000), bid_queues_(256), ask_queues_(256),
+#endif
+          orders_(10000),  //Prevent reallocations
+          bids_(true, tick), asks_(false, tick) {}
     
-    void handle_new_order(const new_order* msg);
+    // True if the order now rests in the book (false: rejected)
+    bool handle_new_order(const new_order* msg);
     void handle_delete_order(const delete_order* msg);
     void handle_modify_order(const modify_order* msg);
-    void handle_trade(const trade* msg);
+    // True if the order still rests after the trade (false: fully
+    // executed, over-traded, or not in this book)
+    bool handle_trade(const trade* msg);
+
+    // Empty the book but keep every table allocated, so a snapshot reset
+    // does not free and re-reserve on the MD thread
+    void clear();
+
+    // Load a snapshot's orders as a batch: insert the orders, then sort by
+    // side and price and load each ladder with its aggregated levels once,
+    // instead of one handle_new_order per order. Same validation as
+    // handle_new_order; snapshot order is kept as time priority in a level.
+    void load_snapshot(const new_order* const* orders, size_t count);
     
     int32_t get_best_bid_price() const;
     uint32_t get_best_bid_qty() const;
@@ -37,16 +127,69 @@ public:
     uint32_t get_last_seq_num() const { return last_seq_num_; }
     void set_last_seq_num(uint32_t seq) { last_seq_num_ = seq; }
 
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+    // Quantity resting ahead of `order_id` at its price level (time
+    // priority), or -1 if the order is not in the book. Walks the queue.
+    int64_t queue_ahead(uint64_t order_id) const;
+    size_t  orders_at_level(SIDE side, int32_t price) const;
+#endif
+
 private:
     uint32_t symbol_;
     uint32_t last_seq_num_;
+    BookAnomalies* anomalies_;
     
-    std::unordered_map<uint64_t, OrderInfo> orders_;
-    std::map<int32_t, uint32_t, std::greater<int32_t>> bids_;
-    std::map<int32_t, uint32_t> asks_;
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+    ObjectPool<OrderNode>   pool_;
+    FlatHashMap<LevelQueue> bid_queues_;   // keyed by price
+    FlatHashMap<LevelQueue> ask_queues_;
+    FlatHashMap<OrderNode*> orders_;
+#else
+    FlatHashMap<OrderInfo> orders_;
+#endif
+    PriceLadder bids_;
+    PriceLadder asks_;
+
+    // Scratch for load_snapshot, kept to reuse its capacity
+    std::vector<const new_order*>             load_orders_;
+    std::vector<std::pair<int32_t, uint32_t>> load_levels_;
     
     void add_to_price_level(SIDE side, int32_t price, uint32_t quantity);
-    void remove_from_price_level(SIDE side, int32_t price, uint32_t quantity);
+    void remove_from_price_level(SIDE side, int32_t price, uint32_t quantity,
+                                 uint64_t order_id);
+
+    bool accept_new(const new_order* msg);
+    void load_side(PriceLadder& ladder, const new_order* const* first,
+                   const new_order* const* last);
+
+    void note(Anomaly a, uint64_t order_id, int32_t price) {
+        if (anomalies_) anomalies_->record(a, order_id, price);
+    }
+
+    // ── Order storage ────────────────────────────────────────────────────────
+    // The handlers go through these so both book modes share them.
+    // requeue_order is called after a modify; in order-by-order mode an
+    // order that changed price or side, or grew, loses its queue priority.
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+    OrderInfo* find_order(uint64_t order_id) {
+        OrderNode** n = orders_.find(order_id);
+        return n ? &(*n)->info : nullptr;
+    }
+    void insert_order (uint64_t order_id, const OrderInfo& info);
+    void erase_order  (uint64_t order_id);
+    void requeue_order(uint64_t order_id, SIDE old_side, int32_t old_price,
+                       uint32_t old_qty);
+
+    FlatHashMap<LevelQueue>&       queues(SIDE side)       { return side == SIDE::BUY ? bid_queues_ : ask_queues_; }
+    const FlatHashMap<LevelQueue>& queues(SIDE side) const { return side == SIDE::BUY ? bid_queues_ : ask_queues_; }
+    void link  (OrderNode* n);
+    void unlink(OrderNode* n);
+#else
+    OrderInfo* find_order(uint64_t order_id) { return orders_.find(order_id); }
+    void insert_order(uint64_t order_id, const OrderInfo& info) { orders_.insert(order_id, info); }
+    void erase_order (uint64_t order_id) { orders_.erase(order_id); }
+    void requeue_order(uint64_t, SIDE, int32_t, uint32_t) {}
+#endif
 };
 
 #endif
\ No newline at end of file
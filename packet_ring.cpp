@@ -0,0 +1,135 @@
+#include "packet_ring.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+// ── Construction ──────────────────────────────────────────────────────────────
+// Reserve 2× capacity of address space, then map the same memfd into both
+// halves. MAP_NORESERVE keeps untouched pages out of the commit charge.
+
+PacketRing::PacketRing(size_t capacity) {
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t cap  = page;
+    while (cap < capacity) cap <<= 1;
+
+    int fd = memfd_create("packet_ring", MFD_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[PacketRing] memfd_create failed: " << strerror(errno) << "\n";
+        return;
+    }
+    if (ftruncate(fd, static_cast<off_t>(cap)) < 0) {
+        std::cerr << "[PacketRing] ftruncate failed: " << strerror(errno) << "\n";
+        close(fd);
+        return;
+    }
+
+    void* region = mmap(nullptr, 2 * cap, PROT_NONE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (region == MAP_FAILED) {
+        std::cerr << "[PacketRing] mmap reserve failed: " << strerror(errno) << "\n";
+        close(fd);
+        return;
+    }
+
+    char* base = static_cast<char*>(region);
+    for (int half = 0; half < 2; ++half) {
+        void* p = mmap(base + half * cap, cap, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_FIXED | MAP_NORESERVE, fd, 0);
+        if (p == MAP_FAILED) {
+            std::cerr << "[PacketRing] mmap mirror failed: " << strerror(errno) << "\n";
+            munmap(region, 2 * cap);
+            close(fd);
+            return;
+        }
+    }
+    base_     = base;
+    fd_       = fd;
+    capacity_ = cap;
+    mask_     = cap - 1;
+}
+
+PacketRing::~PacketRing() {
+    if (base_) munmap(base_, 2 * capacity_);
+    if (fd_ >= 0) close(fd_);
+}
+
+// ── Producer ──────────────────────────────────────────────────────────────────
+
+bool PacketRing::push(const void* data, uint32_t len) {
+    size_t   need = record_size(len);
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t tail = tail_.load(std::memory_order_acquire);
+    if (capacity_ - (head - tail) < need) return false;
+
+    auto* rec     = reinterpret_cast<RecordHeader*>(base_ + (head & mask_));
+    rec->length   = len;
+    rec->reserved = 0;
+    memcpy(rec + 1, data, len);
+
+    pushed_.store(pushed_.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+    head_.store(head + need, std::memory_order_release);
+    return true;
+}
+
+// ── Consumer ──────────────────────────────────────────────────────────────────
+
+char* PacketRing::front(uint32_t& len) const {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    auto* rec = reinterpret_cast<RecordHeader*>(base_ + (tail & mask_));
+    len = rec->length;
+    return reinterpret_cast<char*>(rec + 1);
+}
+
+void PacketRing::pop() {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    auto* rec = reinterpret_cast<RecordHeader*>(base_ + (tail & mask_));
+    popped_.store(popped_.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+    tail_.store(tail + record_size(rec->length), std::memory_order_release);
+}
+
+// Drop everything, release the pages written since the last clear() and
+// start again from offset 0
+void PacketRing::clear() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    // Whole pages: a punch that ends mid-page only zeroes that page
+    size_t   page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t   used = head < capacity_ ? (static_cast<size_t>(head) + page - 1) & ~(page - 1) : capacity_;
+    if (used > 0 && fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+                              0, static_cast<off_t>(used)) < 0)
+        std::cerr << "[PacketRing] fallocate punch failed: " << strerror(errno) << "\n";
+
+    popped_.store(0, std::memory_order_relaxed);
+    pushed_.store(0, std::memory_order_relaxed);
+    tail_.store(0, std::memory_order_release);
+    head_.store(0, std::memory_order_release);
+}
+
+// ── Occupancy ─────────────────────────────────────────────────────────────────
+
+bool PacketRing::empty() const {
+    return head_.load(std::memory_order_acquire)
+        == tail_.load(std::memory_order_acquire);
+}
+
+size_t PacketRing::count() const {
+    return pushed_.load(std::memory_order_acquire)
+         - popped_.load(std::memory_order_acquire);
+}
+
+size_t PacketRing::committed_bytes() const {
+    struct stat st;
+    if (fd_ < 0 || fstat(fd_, &st) < 0) return 0;
+    return static_cast<size_t>(st.st_blocks) * 512;
+}
+
+size_t PacketRing::bytes_used() const {
+    return head_.load(std::memory_order_acquire)
+         - tail_.load(std::memory_order_acquire);
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ── PacketRing ────────────────────────────────────────────────────────────────
+//
+// Fixed-capacity ring of variable-length packets, used by the listener to
+// hold live market data while books are being aligned.
+//
+// Memory:
+//   One memfd mapped twice, back to back. A record that runs off the end of
+//   the ring continues into the mirror, so push() is a single memcpy with
+//   no wrap handling. Pages are only committed when first written, so the
+//   ring can be sized far beyond what a busy startup needs at no RSS cost.
+//   clear() hands the written pages back to the kernel and rewinds both
+//   offsets to 0, so each catch-up reuses the front of the ring and the
+//   commit never outgrows the largest single backlog. Nothing is
+//   allocated after construction.
+//
+// Records are stored at their real length: an 8-byte header, then the
+// payload padded to 8 bytes.
+//
+// Threading:
+//   Single producer (push) / single consumer (pop, clear). head_ and tail_
+//   live on separate cache lines and are published with release/acquire,
+//   so no lock is needed. for_each() and clear() are only safe from the
+//   consumer side while no push() is in flight (clear() rewinds the
+//   producer's offset too) — the listener does both on one thread.
+
+class PacketRing {
+public:
+    // Capacity is rounded up to a power of two (and at least one page).
+    explicit PacketRing(size_t capacity);
+    ~PacketRing();
+
+    PacketRing(const PacketRing&)            = delete;
+    PacketRing& operator=(const PacketRing&) = delete;
+
+    // False if the mapping could not be created
+    bool valid() const { return base_ != nullptr; }
+
+    // Append a packet. Returns false (and stores nothing) if it does not fit.
+    bool push(const void* data, uint32_t len);
+
+    bool   empty()      const;
+    size_t count()      const;
+    size_t bytes_used() const;
+    size_t capacity()   const { return capacity_; }
+
+    // Bytes of the backing memfd actually committed
+    size_t committed_bytes() const;
+
+    // Bytes of ring a packet of `len` bytes occupies
+    static size_t record_size(uint32_t len) {
+        return sizeof(RecordHeader) + ((len + 7u) & ~size_t(7));
+    }
+
+    // Oldest packet — valid until the next pop() or clear()
+    char* front(uint32_t& len) const;
+    void  pop();
+    void  clear();
+
+    // Visit packets oldest-first without consuming them: f(char* data, uint32_t len)
+    template <typename F>
+    void for_each(F&& f) const {
+        uint64_t pos  = tail_.load(std::memory_order_acquire);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (pos != head) {
+            auto* rec = reinterpret_cast<RecordHeader*>(base_ + (pos & mask_));
+            f(reinterpret_cast<char*>(rec + 1), rec->length);
+            pos += record_size(rec->length);
+        }
+    }
+
+private:
+    struct RecordHeader {
+        uint32_t length;
+        uint32_t reserved;
+    };
+
+    char*  base_     = nullptr;
+    int    fd_       = -1;      // kept open to punch out pages on clear()
+    size_t capacity_ = 0;
+    size_t mask_     = 0;
+
+    // Monotonic byte offsets (position in the ring is offset & mask_) and
+    // record counts, one cache line per side.
+    alignas(64) std::atomic<uint64_t> head_{0};     // producer
+    std::atomic<uint64_t>             pushed_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};     // consumer
+    std::atomic<uint64_t>             popped_{0};
+    char pad_[64 - 2 * sizeof(std::atomic<uint64_t>)];
+};
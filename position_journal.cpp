@@ -0,0 +1,165 @@
+#include "position_journal.h"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ── Open / close ──────────────────────────────────────────────────────────────
+
+PositionJournal::~PositionJournal() {
+    close();
+}
+
+bool PositionJournal::open(const std::string& path) {
+    static_assert(sizeof(Header) == 64, "journal header is one cache line");
+    static_assert(sizeof(Record) == 40, "journal record layout is part of the file format");
+
+    close();
+    recovery_ = Recovery{};
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[PositionJournal] cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "[PositionJournal] cannot stat " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+    bool fresh = st.st_size == 0;
+    if (!fresh && static_cast<size_t>(st.st_size) != BYTES) {
+        std::cerr << "[PositionJournal] " << path << " is " << st.st_size
+                  << " bytes, expected " << BYTES << " — refusing to use it\n";
+        ::close(fd);
+        return false;
+    }
+    if (fresh && ftruncate(fd, static_cast<off_t>(BYTES)) != 0) {
+        std::cerr << "[PositionJournal] cannot size " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    void* map = mmap(nullptr, BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "[PositionJournal] cannot map " << path << ": " << std::strerror(errno) << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    auto* header = static_cast<Header*>(map);
+    if (fresh) {
+        std::memset(header, 0, sizeof(Header));
+        header->magic       = MAGIC;
+        header->version     = VERSION;
+        header->max_symbols = MAX_SYMBOLS;
+        header->ring_depth  = RING_DEPTH;
+        header->record_size = sizeof(Record);
+    } else if (header->magic != MAGIC || header->version != VERSION
+               || header->max_symbols != MAX_SYMBOLS || header->ring_depth != RING_DEPTH
+               || header->record_size != sizeof(Record)) {
+        std::cerr << "[PositionJournal] " << path << " is not a journal of this layout\n";
+        munmap(map, BYTES);
+        ::close(fd);
+        return false;
+    }
+
+    fd_      = fd;
+    map_     = map;
+    records_ = reinterpret_cast<Record*>(static_cast<char*>(map) + sizeof(Header));
+    replay();
+    return true;
+}
+
+void PositionJournal::close() {
+    if (map_) {
+        munmap(map_, BYTES);
+        map_     = nullptr;
+        records_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+void PositionJournal::sync() {
+    if (map_) msync(map_, BYTES, MS_SYNC);
+}
+
+// ── Records ───────────────────────────────────────────────────────────────────
+
+// FNV-1a over every byte before the checksum
+uint32_t PositionJournal::checksum(const Record& r) {
+    const auto* p = reinterpret_cast<const unsigned char*>(&r);
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(Record, checksum); ++i) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// Fields first, checksum last: a crash between the two leaves a record that
+// fails verification, never one that passes with mixed contents.
+void PositionJournal::append(uint32_t symbol_id, int32_t position,
+                             int64_t cash, int64_t open_cost) {
+    if (!records_ || symbol_id >= MAX_SYMBOLS) return;
+
+    uint64_t seq = next_seq_.fetch_add(1, std::memory_order_relaxed);
+    uint32_t k   = cursor_[symbol_id]++ % RING_DEPTH;
+    Record&  r   = records_[symbol_id * RING_DEPTH + k];
+
+    Record next{};
+    next.seq             = seq;
+    next.symbol_id       = symbol_id;
+    next.position        = position;
+    next.cash            = cash;
+    next.open_cost       = open_cost;
+    uint32_t sum         = checksum(next);
+
+    r.checksum = 0;
+    std::atomic_signal_fence(std::memory_order_release);
+    r.seq             = next.seq;
+    r.symbol_id       = next.symbol_id;
+    r.position        = next.position;
+    r.cash            = next.cash;
+    r.open_cost       = next.open_cost;
+    std::atomic_signal_fence(std::memory_order_release);
+    r.checksum        = sum;
+}
+
+// ── Replay ────────────────────────────────────────────────────────────────────
+
+// The next write for a symbol goes after its newest valid record, so a torn
+// record is overwritten first and the good history behind it is kept longest.
+void PositionJournal::replay() {
+    std::array<uint64_t, MAX_SYMBOLS> newest{};
+    cursor_.fill(0);
+    for (uint32_t id = 0; id < MAX_SYMBOLS; ++id) {
+        for (uint32_t k = 0; k < RING_DEPTH; ++k) {
+            const Record& r = records_[id * RING_DEPTH + k];
+            if (r.seq == 0) continue;
+            if (r.symbol_id != id || r.checksum != checksum(r)) {
+                ++recovery_.torn;
+                continue;
+            }
+            if (r.seq > newest[id]) {
+                newest[id]                    = r.seq;
+                cursor_[id]                   = k + 1;
+                recovery_.found[id]           = true;
+                recovery_.position[id]        = r.position;
+                recovery_.cash[id]            = r.cash;
+                recovery_.open_cost[id]       = r.open_cost;
+            }
+            if (r.seq > recovery_.last_seq) recovery_.last_seq = r.seq;
+        }
+    }
+    next_seq_.store(recovery_.last_seq + 1, std::memory_order_relaxed);
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "symbol_config.h"
+
+// ── PositionJournal ───────────────────────────────────────────────────────────
+//
+// Crash-safe record of each symbol's position and PnL accounting.
+//
+// The journal is a file mapped MAP_SHARED. Every fill stores one
+// checksummed record carrying the symbol's new position, cash and open
+// cost (see SymbolPnl) — a few stores into the mapping, no syscall. Once
+// stored, the data belongs to the kernel's page cache, so it survives any
+// death of the process (SIGSEGV, exit() in a crash handler, kill -9).
+// Only a kernel crash or power loss needs sync().
+//
+// Each symbol has a small ring of records written round-robin, each
+// stamped from one global sequence number. A record torn by a crash mid-write fails its
+// checksum and recovery falls back to the symbol's previous record. On
+// open() the newest valid record per symbol gives its state.
+//
+// append() may be called from any thread; fills for one symbol are
+// expected from one thread at a time.
+
+class PositionJournal {
+public:
+    // State rebuilt from the file by open()
+    struct Recovery {
+        std::array<bool,    MAX_SYMBOLS> found{};
+        std::array<int32_t, MAX_SYMBOLS> position{};
+        std::array<int64_t, MAX_SYMBOLS> cash{};
+        std::array<int64_t, MAX_SYMBOLS> open_cost{};
+        uint64_t last_seq = 0;   // 0: empty journal
+        size_t   torn     = 0;   // records that failed their checksum
+    };
+
+    PositionJournal() = default;
+    ~PositionJournal();
+
+    PositionJournal(const PositionJournal&)            = delete;
+    PositionJournal& operator=(const PositionJournal&) = delete;
+
+    // Map `path`, creating it if missing, and replay it into recovery().
+    // False (reported on std::cerr) if it cannot be mapped or is not a
+    // journal of this layout.
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return records_ != nullptr; }
+
+    const Recovery& recovery() const { return recovery_; }
+
+    // Record the state after a fill. No-op while closed.
+    void append(uint32_t symbol_id, int32_t position, int64_t cash, int64_t open_cost);
+
+    // Flush the mapping to disk (msync) — for clean shutdown
+    void sync();
+
+    static constexpr uint32_t RING_DEPTH = 4;   // records per symbol
+
+private:
+    struct Header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t max_symbols;
+        uint32_t ring_depth;
+        uint32_t record_size;
+        uint8_t  reserved[40];
+    };
+
+    struct Record {
+        uint64_t seq;              // 0: never written
+        uint32_t symbol_id;
+        int32_t  position;
+        int64_t  cash;
+        int64_t  open_cost;
+        uint32_t checksum;         // over the fields above
+        uint32_t reserved;
+    };
+
+    static constexpr uint64_t MAGIC   = 0x4c4e524a534f5050ull;   // "PPOSJRNL"
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t   BYTES   = sizeof(Header)
+                                      + sizeof(Record) * MAX_SYMBOLS * RING_DEPTH;
+
+    static uint32_t checksum(const Record& r);
+    void replay();
+
+    int                   fd_      = -1;
+    void*                 map_     = nullptr;
+    Record*               records_ = nullptr;   // [symbol][RING_DEPTH]
+    std::atomic<uint64_t> next_seq_{1};
+    std::array<uint32_t, MAX_SYMBOLS> cursor_{};   // next ring slot per symbol
+    Recovery              recovery_;
+};
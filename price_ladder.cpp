@@ -0,0 +1,223 @@
+#include "price_ladder.h"
+
+#include <algorithm>
+
+PriceLadder::PriceLadder(bool bids, int32_t tick)
+    : bids_(bids), tick_(tick > 0 ? tick : 1), qty_(LEVELS, 0) {}
+
+// ── Bitmap ────────────────────────────────────────────────────────────────────
+
+void PriceLadder::set_bit(int32_t idx) {
+    words_[idx >> 6] |= uint64_t(1) << (idx & 63);
+    summary_         |= uint64_t(1) << (idx >> 6);
+}
+
+void PriceLadder::clear_bit(int32_t idx) {
+    uint64_t& w = words_[idx >> 6];
+    w &= ~(uint64_t(1) << (idx & 63));
+    if (w == 0) summary_ &= ~(uint64_t(1) << (idx >> 6));
+}
+
+int32_t PriceLadder::highest() const {
+    if (summary_ == 0) return -1;
+    int w = 63 - __builtin_clzll(summary_);
+    return w * 64 + (63 - __builtin_clzll(words_[w]));
+}
+
+int32_t PriceLadder::lowest() const {
+    if (summary_ == 0) return -1;
+    int w = __builtin_ctzll(summary_);
+    return w * 64 + __builtin_ctzll(words_[w]);
+}
+
+// ── Updates ───────────────────────────────────────────────────────────────────
+
+void PriceLadder::add(int32_t price, uint32_t qty) {
+    if (qty == 0) return;
+
+    int32_t idx = index_of(price);
+    if (idx < 0) {
+        auto it = overflow_.find(price);
+        if (it != overflow_.end()) { it->second += qty; return; }
+        // Off-tick relative to the resting levels: cannot share the array
+        if (count_ > 0 && (price - anchor_) % tick_ != 0) { overflow_[price] += qty; return; }
+        recentre(price);
+        idx = index_of(price);
+        if (idx < 0) { overflow_[price] += qty; return; }
+    }
+
+    if (qty_[idx] == 0) {
+        set_bit(idx);
+        ++count_;
+        if (best_ < 0 || better(idx, best_)) best_ = idx;
+    }
+    qty_[idx] += qty;
+}
+
+void PriceLadder::remove(int32_t price, uint32_t qty) {
+    int32_t idx = index_of(price);
+    if (idx < 0) {
+        auto it = overflow_.find(price);
+        if (it == overflow_.end()) return;
+        it->second -= std::min(qty, it->second);
+        if (it->second == 0) overflow_.erase(it);
+        return;
+    }
+    if (qty_[idx] == 0) return;
+
+    qty_[idx] -= std::min(qty, qty_[idx]);
+    if (qty_[idx] == 0) {
+        clear_bit(idx);
+        --count_;
+        if (idx == best_) best_ = best_index();
+    }
+}
+
+void PriceLadder::erase_level(int32_t price) {
+    remove(price, qty_at(price));
+}
+
+uint32_t PriceLadder::qty_at(int32_t price) const {
+    int32_t idx = index_of(price);
+    if (idx >= 0) return qty_[idx];
+    auto it = overflow_.find(price);
+    return it == overflow_.end() ? 0 : it->second;
+}
+
+void PriceLadder::clear() {
+    for (int w = 0; w < WORDS; ++w) {
+        uint64_t bits = words_[w];
+        while (bits) {
+            qty_[w * 64 + __builtin_ctzll(bits)] = 0;
+            bits &= bits - 1;
+        }
+        words_[w] = 0;
+    }
+    summary_ = 0;
+    count_   = 0;
+    best_    = -1;
+    overflow_.clear();
+}
+
+void PriceLadder::load(const std::pair<int32_t, uint32_t>* levels, size_t n) {
+    clear();
+    if (n == 0) return;
+
+    // Centre on the range if it fits, else on the median level so the bulk
+    // of the book lands in the array and outliers go to overflow
+    int32_t lo = levels[0].first, hi = levels[n - 1].first;
+    int64_t span = (int64_t(hi) - lo) / tick_ + 1;
+    if (span <= LEVELS) {
+        anchor_ = lo - static_cast<int32_t>((LEVELS - span) / 2) * tick_;
+    } else {
+        lo      = levels[n / 2].first;
+        anchor_ = lo - (LEVELS / 2) * tick_;
+    }
+    if (anchor_ < 0) anchor_ = lo % tick_;
+
+    for (size_t i = 0; i < n; ++i) {
+        int32_t  px = levels[i].first;
+        uint32_t q  = levels[i].second;
+        if (q == 0) continue;
+        int32_t idx = index_of(px);
+        if (idx < 0) { overflow_[px] += q; continue; }
+        qty_[idx] = q;
+        set_bit(idx);
+        ++count_;
+    }
+    best_ = best_index();
+}
+
+// ── Top of book ───────────────────────────────────────────────────────────────
+// The overflow map is empty in normal trading, so this is one load of the
+// tracked best index plus a branch.
+
+int32_t PriceLadder::best_price() const {
+    if (overflow_.empty()) return best_ < 0 ? 0 : price_of(best_);
+
+    int32_t ovf = bids_ ? overflow_.rbegin()->first : overflow_.begin()->first;
+    if (best_ < 0 || better(ovf, price_of(best_))) return ovf;
+    return price_of(best_);
+}
+
+uint32_t PriceLadder::best_qty() const {
+    if (overflow_.empty()) return best_ < 0 ? 0 : qty_[best_];
+    return qty_at(best_price());
+}
+
+// ── Re-centring ───────────────────────────────────────────────────────────────
+// Move the window so it covers the occupied range plus `price`, centred.
+// If that range is wider than the window, leave everything where it is and
+// let the caller park `price` in overflow.
+
+void PriceLadder::recentre(int32_t price) {
+    int32_t lo = price, new_anchor;
+    if (count_ == 0) {
+        new_anchor = price - (LEVELS / 2) * tick_;
+    } else {
+        lo           = std::min(price_of(lowest()),  price);
+        int32_t hi   = std::max(price_of(highest()), price);
+        int64_t span = (int64_t(hi) - lo) / tick_ + 1;
+        if (span > LEVELS) return;
+        new_anchor = lo - static_cast<int32_t>((LEVELS - span) / 2) * tick_;
+    }
+    // Prices are never negative; stay on lo's tick grid
+    if (new_anchor < 0) new_anchor = lo % tick_;
+
+    // Collect occupied levels, then lay them out against the new anchor
+    std::vector<std::pair<int32_t, uint32_t>> held;
+    held.reserve(count_);
+    for (int w = 0; w < WORDS; ++w) {
+        uint64_t bits = words_[w];
+        while (bits) {
+            int32_t idx = w * 64 + __builtin_ctzll(bits);
+            held.emplace_back(price_of(idx), qty_[idx]);
+            qty_[idx] = 0;
+            bits &= bits - 1;
+        }
+        words_[w] = 0;
+    }
+    summary_ = 0;
+    count_   = 0;
+    best_    = -1;
+    anchor_  = new_anchor;
+
+    auto place = [&](int32_t px, uint32_t q) {
+        int32_t idx = index_of(px);
+        qty_[idx] = q;
+        set_bit(idx);
+        ++count_;
+    };
+    for (auto& [px, q] : held) place(px, q);
+
+    // Overflow levels that now fall inside the window move into the array
+    for (auto it = overflow_.begin(); it != overflow_.end(); ) {
+        if (index_of(it->first) >= 0) {
+            place(it->first, it->second);
+            it = overflow_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    best_ = best_index();
+}
+
+// ── Diagnostics ───────────────────────────────────────────────────────────────
+
+std::vector<std::pair<int32_t, uint32_t>> PriceLadder::levels() const {
+    std::vector<std::pair<int32_t, uint32_t>> out;
+    for (int w = 0; w < WORDS; ++w) {
+        uint64_t bits = words_[w];
+        while (bits) {
+            int32_t idx = w * 64 + __builtin_ctzll(bits);
+            out.emplace_back(price_of(idx), qty_[idx]);
+            bits &= bits - 1;
+        }
+    }
+    for (auto& kv : overflow_) out.emplace_back(kv.first, kv.second);
+
+    std::sort(out.begin(), out.end(), [&](const auto& a, const auto& b) {
+        return better(a.first, b.first);
+    });
+    return out;
+}
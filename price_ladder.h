@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+// ── PriceLadder ───────────────────────────────────────────────────────────────
+//
+// Aggregated quantity per price level for one side of a book.
+//
+// Levels live in a dense array indexed by (price - anchor) / tick, so add and
+// remove are an index computation and a store — no tree walk, no allocation.
+// A two-level bitmap (one bit per level, one summary bit per 64 levels) finds
+// the next best level in O(1) when the top empties.
+//
+// The window covers LEVELS ticks. A price outside it re-centres the anchor
+// over the occupied range; if the range is too wide to fit, the outlying
+// level is kept in a small overflow map instead. Overflow prices are always
+// outside the current window and move back into the array on re-centre.
+
+class PriceLadder {
+public:
+    static constexpr int32_t LEVELS = 4096;   // 64 words × 64 bits
+
+    // bids: best level is the highest price; asks: the lowest
+    explicit PriceLadder(bool bids, int32_t tick = 1);
+
+    void     add   (int32_t price, uint32_t qty);
+    // Caller guarantees qty <= qty_at(price)
+    void     remove(int32_t price, uint32_t qty);
+    void     erase_level(int32_t price);
+    uint32_t qty_at(int32_t price) const;
+
+    bool     empty()      const { return count_ == 0 && overflow_.empty(); }
+    int32_t  best_price() const;   // 0 if empty
+    uint32_t best_qty()   const;   // 0 if empty
+
+    void     clear();
+
+    // Bulk-load an empty ladder from levels sorted by ascending price with
+    // no duplicates. Places the window once over the whole range instead of
+    // re-centring as levels arrive one at a time.
+    void     load(const std::pair<int32_t, uint32_t>* levels, size_t n);
+
+    // All levels, best first — diagnostics only
+    std::vector<std::pair<int32_t, uint32_t>> levels() const;
+
+private:
+    static constexpr int WORDS = LEVELS / 64;
+
+    bool    bids_;
+    int32_t tick_;
+    int32_t anchor_ = 0;      // price at index 0
+    int32_t count_  = 0;      // occupied levels in the window
+    int32_t best_   = -1;     // index of the best window level, -1 if none
+
+    std::vector<uint32_t>       qty_;
+    uint64_t                    words_[WORDS] = {};
+    uint64_t                    summary_      = 0;
+    std::map<int32_t, uint32_t> overflow_;
+
+    // Index of `price` in the window, or -1 if it is outside / off-tick
+    int32_t index_of(int32_t price) const {
+        int32_t off = price - anchor_;
+        if (off < 0 || off % tick_ != 0) return -1;
+        int32_t idx = off / tick_;
+        return idx < LEVELS ? idx : -1;
+    }
+    int32_t price_of(int32_t idx) const { return anchor_ + idx * tick_; }
+
+    void set_bit  (int32_t idx);
+    void clear_bit(int32_t idx);
+    int32_t highest() const;   // -1 if none
+    int32_t lowest()  const;   // -1 if none
+    int32_t best_index() const { return bids_ ? highest() : lowest(); }
+
+    bool better(int32_t a, int32_t b) const { return bids_ ? a > b : a < b; }
+
+    void recentre(int32_t price);
+};
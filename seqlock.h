@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// ── SeqLock ───────────────────────────────────────────────────────────────────
+//
+// Single-writer sequence lock publishing a small record as one consistent
+// value. The writer makes the sequence odd, stores the record, then makes
+// it even again; a reader copies the record between two loads of the
+// sequence and retries if they differ or were odd. Readers never block the
+// writer and never write shared memory, so they cost the writer nothing.
+//
+// The record is kept as relaxed atomic words so concurrent copies are not
+// a data race; the fences order them against the sequence.
+
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock records must be trivially copyable");
+    static constexpr size_t WORDS = (sizeof(T) + 7) / 8;
+
+public:
+    SeqLock() { store(T{}); }
+
+    // Writer side — one thread only
+    void store(const T& value) {
+        uint64_t buf[WORDS] = {};
+        std::memcpy(buf, &value, sizeof(T));
+
+        uint32_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i)
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side — any thread; spins while a write is in progress
+    T load() const {
+        T out;
+        while (!try_load(out, nullptr)) {}
+        return out;
+    }
+
+    // One attempt; false if it overlapped a write. `seq_out` (if set)
+    // receives the version the record was read at.
+    bool try_load(T& out, uint32_t* seq_out) const {
+        uint64_t buf[WORDS];
+        uint32_t before = seq_.load(std::memory_order_acquire);
+        if (before & 1) return false;
+        for (size_t i = 0; i < WORDS; ++i)
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq_.load(std::memory_order_relaxed) != before) return false;
+
+        std::memcpy(&out, buf, sizeof(T));
+        if (seq_out) *seq_out = before;
+        return true;
+    }
+
+    // Even once the first write has completed; bumps by 2 per store
+    uint32_t version() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint64_t> words_[WORDS];
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// ── SpscQueue ─────────────────────────────────────────────────────────────────
+//
+// Bounded single-producer / single-consumer queue of trivially copyable
+// records. N is a power of two; slots live inline, so nothing is
+// allocated after construction.
+//
+// head_ (producer) and tail_ (consumer) are monotonic counters on separate
+// cache lines, published with release/acquire. Each side also keeps a
+// private copy of the other's counter and only reloads it when the queue
+// looks full (producer) or empty (consumer), so a steady stream costs one
+// shared cache-line transfer per batch rather than per record.
+
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue capacity must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpscQueue records must be trivially copyable");
+
+public:
+    static constexpr size_t CAPACITY = N;
+
+    // Producer side. False (nothing stored) if the queue is full.
+    bool try_push(const T& value) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == N) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == N) return false;
+        }
+        slots_[head & (N - 1)] = value;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side. False if the queue is empty.
+    bool try_pop(T& out) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) return false;
+        }
+        out = slots_[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate from either side; exact when the other side is idle
+    size_t size() const {
+        return static_cast<size_t>(head_.load(std::memory_order_acquire)
+                                 - tail_.load(std::memory_order_acquire));
+    }
+    bool empty() const { return size() == 0; }
+
+private:
+    alignas(64) std::atomic<uint64_t> head_{0};   // producer
+    uint64_t                          tail_cache_ = 0;
+    alignas(64) std::atomic<uint64_t> tail_{0};   // consumer
+    uint64_t                          head_cache_ = 0;
+    alignas(64) std::array<T, N>      slots_{};
+};
@@ -0,0 +1,152 @@
+#include "symbol_config.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// ── Built-in universe ─────────────────────────────────────────────────────────
+
+SymbolConfig SymbolConfig::defaults() {
+    static const char* const NAMES[] = {
+        "GOLD", "BLUE", "KNAN", "STED", "FISH", "DILN", "SORN",
+        "RYAN", "LYON", "WLSH", "LEWI", "BDIN", "UNDY"
+    };
+
+    // GOLD and BLUE trade on coarser grids; everything else on 1
+    SymbolConfig c;
+    for (uint32_t id = SYM_GOLD; id <= SYM_UNDY; ++id) {
+        int32_t tick = id == SYM_GOLD ? 10 : id == SYM_BLUE ? 5 : 1;
+        c.add_symbol({ id, NAMES[id - 1], tick, 9 });
+    }
+
+    BasketConfig basket;
+    basket.etf_id = SYM_UNDY;
+    for (uint32_t id = SYM_KNAN; id <= SYM_BDIN; ++id)
+        basket.legs.push_back({ id, 1 });
+    c.set_basket(basket);
+    return c;
+}
+
+// ── Builders ──────────────────────────────────────────────────────────────────
+
+bool SymbolConfig::add_symbol(const SymbolInfo& info) {
+    if (info.id == 0 || info.id >= MAX_SYMBOLS) {
+        std::cerr << "[SymbolConfig] symbol id " << info.id
+                  << " outside 1.." << MAX_SYMBOLS - 1 << "\n";
+        return false;
+    }
+    if (has(info.id) || find(info.name) != 0) {
+        std::cerr << "[SymbolConfig] duplicate symbol " << info.id
+                  << " " << info.name << "\n";
+        return false;
+    }
+    if (info.name.empty() || info.tick <= 0 || info.position_limit <= 0) {
+        std::cerr << "[SymbolConfig] symbol " << info.id
+                  << " needs a name, tick > 0 and position limit > 0\n";
+        return false;
+    }
+
+    symbols_.push_back(info);
+    index_[info.id] = static_cast<int8_t>(symbols_.size());
+    ids_.insert(std::upper_bound(ids_.begin(), ids_.end(), info.id), info.id);
+    return true;
+}
+
+bool SymbolConfig::set_basket(const BasketConfig& basket) {
+    if (!has(basket.etf_id)) {
+        std::cerr << "[SymbolConfig] basket ETF " << basket.etf_id << " is not a symbol\n";
+        return false;
+    }
+    if (basket.legs.empty() || basket.legs.size() > MAX_BASKET_LEGS) {
+        std::cerr << "[SymbolConfig] basket needs 1.." << MAX_BASKET_LEGS << " legs\n";
+        return false;
+    }
+    uint32_t seen = 0;   // bit per symbol id
+    for (const BasketLeg& leg : basket.legs) {
+        if (!has(leg.symbol_id) || leg.symbol_id == basket.etf_id
+            || (seen & (1u << leg.symbol_id)) || leg.weight <= 0) {
+            std::cerr << "[SymbolConfig] bad basket leg " << leg.symbol_id
+                      << " weight " << leg.weight << "\n";
+            return false;
+        }
+        seen |= 1u << leg.symbol_id;
+    }
+    basket_ = basket;
+    return true;
+}
+
+// ── Lookup ────────────────────────────────────────────────────────────────────
+
+bool SymbolConfig::has(uint32_t id) const {
+    return id < MAX_SYMBOLS && index_[id] != 0;
+}
+
+const SymbolInfo& SymbolConfig::symbol(uint32_t id) const {
+    return symbols_[index_[id] - 1];
+}
+
+uint32_t SymbolConfig::find(const std::string& name) const {
+    for (const SymbolInfo& s : symbols_)
+        if (s.name == name) return s.id;
+    return 0;
+}
+
+// ── File ──────────────────────────────────────────────────────────────────────
+
+bool SymbolConfig::load(const std::string& path) {
+    std::ifstream f(path);
+    if (!f.is_open()) {
+        std::cout << "[SymbolConfig] No " << path << " — using built-in universe\n";
+        return true;
+    }
+
+    SymbolConfig c;
+    BasketConfig basket;
+    std::string  line;
+    int          line_no = 0;
+
+    auto fail = [&](const char* why) {
+        std::cerr << "[SymbolConfig] " << path << ":" << line_no << ": " << why
+                  << " — '" << line << "'\n";
+        return false;
+    };
+
+    while (std::getline(f, line)) {
+        ++line_no;
+        std::istringstream in(line.substr(0, line.find('#')));
+        std::string directive;
+        if (!(in >> directive)) continue;
+
+        if (directive == "symbol") {
+            SymbolInfo s;
+            if (!(in >> s.id >> s.name >> s.tick >> s.position_limit))
+                return fail("expected: symbol <id> <name> <tick> <position_limit>");
+            if (!c.add_symbol(s)) return fail("invalid symbol");
+        } else if (directive == "basket") {
+            std::string name;
+            if (!(in >> name))          return fail("expected: basket <etf name>");
+            if (!(basket.etf_id = c.find(name))) return fail("unknown symbol");
+        } else if (directive == "leg") {
+            BasketLeg   leg;
+            std::string name;
+            if (!(in >> name >> leg.weight)) return fail("expected: leg <name> <weight>");
+            if (!(leg.symbol_id = c.find(name)))  return fail("unknown symbol");
+            basket.legs.push_back(leg);
+        } else if (directive == "cash") {
+            if (!(in >> basket.cash)) return fail("expected: cash <amount>");
+        } else {
+            return fail("unknown directive");
+        }
+    }
+
+    if (basket.etf_id != 0 || !basket.legs.empty()) {
+        line = "basket";
+        if (!c.set_basket(basket)) return fail("invalid basket");
+    }
+
+    *this = std::move(c);
+    std::cout << "[SymbolConfig] Loaded " << ids_.size() << " symbols, "
+              << basket_.legs.size() << " basket legs from " << path << "\n";
+    return true;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ── Universe limits ───────────────────────────────────────────────────────────
+// Symbol ids are small exchange-assigned integers and every per-symbol table
+// is an array indexed by id. Change masks carry one bit per id in a
+// uint32_t, so ids run 1..MAX_SYMBOLS-1 (index 0 unused). Basket legs are
+// distinct symbols other than the ETF, so a basket has at most
+// MAX_SYMBOLS-2 legs; the cap rounds that up to whole 8-lane kernel
+// blocks. Missing-leg masks carry one bit per leg in a uint64_t.
+
+static constexpr uint32_t MAX_SYMBOLS     = 32;
+static constexpr size_t   MAX_BASKET_LEGS = 32;
+
+static_assert(MAX_BASKET_LEGS >= MAX_SYMBOLS - 2, "every expressible basket must fit");
+
+// ── Default universe ids ──────────────────────────────────────────────────────
+// The exchange's current symbols, as built into SymbolConfig::defaults().
+// Runtime code resolves symbols through the loaded SymbolConfig; these
+// name the built-in table and the fixtures in the tests.
+
+static constexpr uint32_t SYM_GOLD = 1;
+static constexpr uint32_t SYM_BLUE = 2;
+static constexpr uint32_t SYM_KNAN = 3;
+static constexpr uint32_t SYM_STED = 4;
+static constexpr uint32_t SYM_FISH = 5;
+static constexpr uint32_t SYM_DILN = 6;
+static constexpr uint32_t SYM_SORN = 7;
+static constexpr uint32_t SYM_RYAN = 8;
+static constexpr uint32_t SYM_LYON = 9;
+static constexpr uint32_t SYM_WLSH = 10;
+static constexpr uint32_t SYM_LEWI = 11;
+static constexpr uint32_t SYM_BDIN = 12;
+static constexpr uint32_t SYM_UNDY = 13;
+
+// ── SymbolInfo ────────────────────────────────────────────────────────────────
+struct SymbolInfo {
+    uint32_t    id;
+    std::string name;
+    int32_t     tick;             // book price granularity
+    int32_t     position_limit;   // largest |position| we will hold
+};
+
+// ── BasketConfig ──────────────────────────────────────────────────────────────
+// ETF creation unit: `weight` lots of each leg plus `cash` (in price
+// units, may be negative) per lot of the ETF.
+struct BasketLeg {
+    uint32_t symbol_id;
+    int32_t  weight;
+};
+
+struct BasketConfig {
+    uint32_t               etf_id = 0;   // 0: no basket configured
+    std::vector<BasketLeg> legs;
+    int32_t                cash   = 0;
+};
+
+// ── SymbolConfig ──────────────────────────────────────────────────────────────
+//
+// The tradeable universe and ETF basket, read once at startup and fixed
+// for the life of the process. Consumers copy what they need into dense
+// id-indexed arrays; nothing here is on a hot path.
+//
+// File format, one directive per line, '#' starts a comment:
+//
+//   symbol <id> <name> <tick> <position_limit>
+//   basket <etf name>
+//   leg    <name> <weight>
+//   cash   <amount>
+//
+// Symbols must be declared before the basket lines that name them.
+
+class SymbolConfig {
+public:
+    // The exchange universe: 13 symbols, UNDY = 1 lot of each of the 10
+    // dorms and no cash
+    static SymbolConfig defaults();
+
+    // Replace this config with the file's contents. A missing file keeps
+    // the current config; a malformed or inconsistent one is reported on
+    // std::cerr, leaves *this unchanged and returns false.
+    bool load(const std::string& path);
+
+    // Builders — return false (and change nothing) on an invalid entry
+    bool add_symbol(const SymbolInfo& info);
+    bool set_basket(const BasketConfig& basket);
+
+    bool                         has(uint32_t id) const;
+    const SymbolInfo&            symbol(uint32_t id) const;   // id must be has()
+    const std::vector<uint32_t>& ids() const { return ids_; }  // ascending
+    const BasketConfig&          basket() const { return basket_; }
+
+    // Id of the symbol called `name`, or 0
+    uint32_t find(const std::string& name) const;
+
+private:
+    std::vector<SymbolInfo>          symbols_;
+    std::vector<uint32_t>            ids_;
+    std::array<int8_t, MAX_SYMBOLS>  index_{};   // id → symbols_ index + 1, 0 if absent
+    BasketConfig                     basket_;
+};
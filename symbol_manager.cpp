@@ -3,14 +3,39 @@
 #include <stdexcept>
 #include <cmath>
 #include <string>
+#include <thread>
+#include <climits>
+#include <iostream>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 // ── Construction ──────────────────────────────────────────────────────────────
 
-SymbolManager::SymbolManager() : total_pnl_(0.0) {
-    for (uint32_t id = 1; id <= 13; ++id) {
+SymbolManager::SymbolManager(const SymbolConfig& config)
+    : config_(config) {
+    for (uint32_t id : config_.ids()) {
+        const SymbolInfo& info = config_.symbol(id);
         //slots_.emplace(id, std::make_unique<SymbolSlot>(id));
-        slots_[id] = std::make_unique<SymbolSlot>(id);
+        slots_[id]          = std::make_unique<SymbolSlot>(id, info.tick);
+        position_limit_[id] = info.position_limit;
     }
+
+    // Basket as dense tables; every leg starts without prices
+    const BasketConfig& basket = config_.basket();
+    etf_id_    = basket.etf_id;
+    leg_count_ = basket.legs.size();
+    dorm_index_.fill(-1);
+    for (size_t i = 0; i < leg_count_; ++i) {
+        leg_id_[i]     = basket.legs[i].symbol_id;
+        leg_weight_[i] = basket.legs[i].weight;
+        dorm_index_[leg_id_[i]] = static_cast<int8_t>(i);
+    }
+    cash_ = basket.cash;
+    nav_work_.nav_bid = nav_work_.nav_ask = cash_;
+    nav_work_.bid_missing = nav_work_.ask_missing =
+        (uint64_t{1} << leg_count_) - 1;
+    if (etf_id_ != 0) refresh_edges();
 }
 
 // ── Safe accessor ─────────────────────────────────────────────────────────────
@@ -36,186 +61,415 @@ const SymbolManager::SymbolSlot& SymbolManager::slot(uint32_t id) const {
 // ── Market data thread ────────────────────────────────────────────────────────
 // Pattern for every handler:
 //   1. Update the full OrderBook (market data thread only — no sync needed)
-//   2. Flush updated top-of-book into atomics with memory_order_release
-//      so the strategy thread sees a consistent view on next acquire-load.
+//   2. touch() the slot so its top of book is published, either now or
+//      with the rest of the packet batch at end_batch().
 
-void SymbolManager::on_new_order(uint32_t id, const new_order* msg) {
-    auto& s = slot(id);
-    s.book.handle_new_order(msg);
-    s.flush_top_of_book();
+bool SymbolManager::on_new_order(uint32_t id, const new_order* msg) {
+    bool resting = slot(id).book.handle_new_order(msg);
+    touch(id);
+    return resting;
 }
 
 void SymbolManager::on_delete_order(uint32_t id, const delete_order* msg) {
-    auto& s = slot(id);
-    s.book.handle_delete_order(msg);
-    s.flush_top_of_book();
+    slot(id).book.handle_delete_order(msg);
+    touch(id);
 }
 
 void SymbolManager::on_modify_order(uint32_t id, const modify_order* msg) {
-    auto& s = slot(id);
-    s.book.handle_modify_order(msg);
-    s.flush_top_of_book();
+    slot(id).book.handle_modify_order(msg);
+    touch(id);
+}
+
+bool SymbolManager::on_trade(uint32_t id, const trade* msg) {
+    bool resting = slot(id).book.handle_trade(msg);
+    touch(id);
+    return resting;
+}
+
+// ── Batch publication ─────────────────────────────────────────────────────────
+
+void SymbolManager::begin_batch() {
+    in_batch_ = true;
+}
+
+void SymbolManager::end_batch(uint64_t feed_timestamp) {
+    in_batch_ = false;
+    if (dirty_ == 0) return;   // nothing moved: no epoch, no wake
+    publish(dirty_, feed_timestamp);
+    dirty_ = 0;
+}
+
+// NAV and missing masks by delta: an empty side is price 0, so it adds
+// nothing to the sum and only flips its missing bit
+void SymbolManager::apply_leg(int8_t dorm, const TopOfBook& prev, const TopOfBook& next) {
+    uint64_t bit    = uint64_t{1} << dorm;
+    int32_t  weight = leg_weight_[dorm];
+    nav_work_.nav_bid += weight * (next.bid_price - prev.bid_price);
+    nav_work_.nav_ask += weight * (next.ask_price - prev.ask_price);
+    if (next.bid_price == 0) nav_work_.bid_missing |= bit;
+    else                     nav_work_.bid_missing &= ~bit;
+    if (next.ask_price == 0) nav_work_.ask_missing |= bit;
+    else                     nav_work_.ask_missing &= ~bit;
+}
+
+void SymbolManager::refresh_edges() {
+    const TopOfBook& undy = slot(etf_id_).published;
+    nav_work_.creation_edge = (nav_work_.ask_missing || undy.bid_price == 0)
+        ? ArbEdges::NO_EDGE : undy.bid_price - nav_work_.nav_ask;
+    nav_work_.redemption_edge = (nav_work_.bid_missing || undy.ask_price == 0)
+        ? ArbEdges::NO_EDGE : nav_work_.nav_bid - undy.ask_price;
+
+    nav_.store(nav_work_);
+    edges_.store(static_cast<uint64_t>(static_cast<uint32_t>(nav_work_.creation_edge)) << 32
+               | static_cast<uint32_t>(nav_work_.redemption_edge),
+                 std::memory_order_release);
+}
+
+ArbEdges SymbolManager::edges() const {
+    uint64_t packed = edges_.load(std::memory_order_acquire);
+    return { static_cast<int32_t>(static_cast<uint32_t>(packed >> 32)),
+             static_cast<int32_t>(static_cast<uint32_t>(packed)) };
+}
+
+// ── Change notification ───────────────────────────────────────────────────────
+// The counter bump and the parked_ check are both seq_cst, pairing with the
+// waiter's parked_ increment and futex compare: either the waiter sees the
+// new count, or the publisher sees it parked and wakes it.
+
+static long futex(std::atomic<uint32_t>* addr, int op, uint32_t val,
+                  const timespec* timeout) {
+    return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val,
+                   timeout, nullptr, 0);
 }
 
-void SymbolManager::on_trade(uint32_t id, const trade* msg) {
-    auto& s = slot(id);
-    s.book.handle_trade(msg);
-    s.flush_top_of_book();
+void SymbolManager::notify(uint32_t mask) {
+    changed_mask_.fetch_or(mask, std::memory_order_release);
+    change_seq_.fetch_add(1, std::memory_order_seq_cst);
+    if (parked_.load(std::memory_order_seq_cst))
+        futex(&change_seq_, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr);
 }
 
-void SymbolManager::save_positions(const std::string& path) const {
-    std::ofstream f(path);
-    for (uint32_t id = 1; id <= 13; ++id) {
-        int32_t pos = slot(id).position.load(std::memory_order_acquire);
-        if (pos != 0) f << id << " " << pos << "\n";
+uint32_t SymbolManager::change_seq() const {
+    return change_seq_.load(std::memory_order_acquire);
+}
+
+uint32_t SymbolManager::take_changes() {
+    return changed_mask_.exchange(0, std::memory_order_acquire);
+}
+
+uint32_t SymbolManager::wait_for_change(uint32_t seen, WaitMode mode,
+                                        std::chrono::microseconds timeout) const {
+    using clock = std::chrono::steady_clock;
+    constexpr int SPINS_BEFORE_PARK = 4000;
+    auto deadline = clock::now() + timeout;
+    auto& seq     = change_seq_;
+
+    for (int spins = 0; ; ++spins) {
+        uint32_t now = seq.load(std::memory_order_acquire);
+        if (now != seen) return now;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+        if ((spins & 255) == 255 && clock::now() >= deadline) return now;
+        if (mode == WaitMode::BUSY_POLL || spins < SPINS_BEFORE_PARK) continue;
+
+        // Park until a publisher bumps the counter or the deadline passes
+        auto left = deadline - clock::now();
+        if (left <= clock::duration::zero()) return seq.load(std::memory_order_acquire);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+        timespec ts{ static_cast<time_t>(ns / 1'000'000'000), static_cast<long>(ns % 1'000'000'000) };
+
+        parked_.fetch_add(1, std::memory_order_seq_cst);
+        futex(&seq, FUTEX_WAIT_PRIVATE, seen, &ts);
+        parked_.fetch_sub(1, std::memory_order_relaxed);
+        return seq.load(std::memory_order_acquire);
     }
-    std::cout << "[SymbolManager] Positions saved to " << path << "\n";
 }
 
-void SymbolManager::load_positions(const std::string& path) {
-    std::ifstream f(path);
-    if (!f.is_open()) {
-        std::cout << "[SymbolManager] No saved positions found\n";
-        return;
+uint64_t SymbolManager::epoch() const {
+    return epoch_.load(std::memory_order_acquire);
+}
+
+void SymbolManager::touch(uint32_t symbol_id) {
+    if (in_batch_) dirty_ |= 1u << symbol_id;
+    else           publish(1u << symbol_id, feed_ts_.load(std::memory_order_relaxed));
+}
+
+// Store every slot in `mask` and advance the epoch, inside one write
+// section of epoch_seq_
+void SymbolManager::publish(uint32_t mask, uint64_t feed_timestamp) {
+    uint32_t published = mask;
+    uint32_t seq = epoch_seq_.load(std::memory_order_relaxed);
+    epoch_seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    bool basket_changed = false;
+    while (mask) {
+        uint32_t  id   = __builtin_ctz(mask);
+        auto&     s    = slot(id);
+        TopOfBook next = s.current_top();
+        if (dorm_index_[id] >= 0) {
+            apply_leg(dorm_index_[id], s.published, next);
+            basket_changed = true;
+        }
+        basket_changed |= id == etf_id_;
+        s.published = next;
+        tob_[id].store(next);
+        mask &= mask - 1;
     }
-    uint32_t id; int32_t pos;
-    while (f >> id >> pos) {
-        slot(id).position.store(pos, std::memory_order_release);
-        std::cout << "[SymbolManager] Loaded sym=" << id
-                  << " pos=" << pos << "\n";
+    if (basket_changed) refresh_edges();
+
+    epoch_  .store(epoch_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    feed_ts_.store(feed_timestamp, std::memory_order_relaxed);
+
+    epoch_seq_.store(seq + 2, std::memory_order_release);
+
+    if (published) notify(published);
+}
+
+// ── Position journal ──────────────────────────────────────────────────────────
+
+bool SymbolManager::open_journal(const std::string& path, const std::string& legacy_positions) {
+    // positions.txt held quantities without entry prices, so it cannot seed
+    // the journal's cost basis. Starting flat on top of it would trade on
+    // the wrong inventory; make the operator settle it first.
+    if (!legacy_positions.empty() && access(path.c_str(), F_OK) != 0
+            && access(legacy_positions.c_str(), F_OK) == 0) {
+        std::cerr << "[SymbolManager] " << legacy_positions << " exists but journal " << path
+                  << " does not — flatten or reconcile those positions and remove "
+                  << legacy_positions << " before starting\n";
+        return false;
     }
+    if (!journal_.open(path)) return false;
+
+    const PositionJournal::Recovery& rec = journal_.recovery();
+    if (rec.torn)
+        std::cerr << "[SymbolManager] Journal " << path << ": skipped "
+                  << rec.torn << " torn record(s)\n";
+    for (uint32_t id = 0; id < MAX_SYMBOLS; ++id) {
+        if (!rec.found[id]) continue;
+        if (!config_.has(id)) {
+            std::cerr << "[SymbolManager] Ignoring journalled position for unknown sym=" << id << "\n";
+            continue;
+        }
+        pnl_work_[id] = { rec.position[id], rec.cash[id], rec.open_cost[id] };
+        pnl_[id].store(pnl_work_[id]);
+        position_[id].store(rec.position[id], std::memory_order_release);
+        if (rec.position[id] != 0)
+            std::cout << "[SymbolManager] Restored sym=" << id << " pos=" << rec.position[id]
+                      << " avg=" << avg_entry_price(id) << "\n";
+    }
+    std::cout << "[SymbolManager] Journal " << path
+              << (rec.last_seq ? " replayed" : " is new")
+              << ", realized pnl=" << pnl().realized << "\n";
+    return true;
+}
+
+void SymbolManager::sync_journal() {
+    journal_.sync();
 }
 
 void SymbolManager::reset_book(uint32_t symbol_id) {
     auto& s = slot(symbol_id);
-    s.book = OrderBook(symbol_id);   // replace with fresh book
-    s.best_bid_price.store(0, std::memory_order_release);
-    s.best_bid_qty  .store(0, std::memory_order_release);
-    s.best_ask_price.store(0, std::memory_order_release);
-    s.best_ask_qty  .store(0, std::memory_order_release);
+    s.book.clear();   // keeps tables allocated
+    touch(symbol_id);
 }
 
-// ── Fill callback ─────────────────────────────────────────────────────────────
-// Updates atomic position and global PnL.
-// Uses a CAS loop for the PnL double — spins in user space, no kernel call.
+void SymbolManager::load_snapshot(uint32_t symbol_id,
+                                  const new_order* const* orders, size_t count) {
+    slot(symbol_id).book.load_snapshot(orders, count);
+    touch(symbol_id);
+}
 
-void SymbolManager::on_fill(uint32_t symbol_id, SIDE side,
-                             uint32_t qty, int32_t price) {
+// ── Sequence recovery ─────────────────────────────────────────────────────────
+
+void SymbolManager::mark_stale(uint32_t symbol_id) {
     auto& s = slot(symbol_id);
-    int32_t old_pos = s.position.load(std::memory_order_acquire);
-
-    // Update position
-    if (side == SIDE::BUY)
-        s.position.fetch_add(static_cast<int32_t>(qty), std::memory_order_release);
-    else
-        s.position.fetch_sub(static_cast<int32_t>(qty), std::memory_order_release);
-
-    // Update average entry price
-    if (side == SIDE::BUY) {
-        double old_val = avg_entry_price_[symbol_id] * std::max(old_pos, 0);
-        double new_qty = old_pos + static_cast<int32_t>(qty);
-        avg_entry_price_[symbol_id] = new_qty > 0
-            ? (old_val + price * qty) / new_qty
-            : price;
-    }
+    s.stale.store(true, std::memory_order_release);
+    touch(symbol_id);
+}
 
-    // Only book realized PnL when reducing position
-    bool reducing = (side == SIDE::SELL && old_pos > 0) ||
-                    (side == SIDE::BUY  && old_pos < 0);
+void SymbolManager::clear_stale(uint32_t symbol_id) {
+    auto& s = slot(symbol_id);
+    s.stale.store(false, std::memory_order_release);
+    touch(symbol_id);
+}
 
-    if (!reducing) return;
+bool SymbolManager::is_stale(uint32_t symbol_id) const {
+    return slot(symbol_id).stale.load(std::memory_order_acquire);
+}
 
-    uint32_t closing_qty = std::min(qty, static_cast<uint32_t>(std::abs(old_pos)));
-    double avg_entry     = avg_entry_price_[symbol_id];
-    double realized      = (side == SIDE::SELL)
-        ? (price - avg_entry) * closing_qty
-        : (avg_entry - price) * closing_qty;
+uint32_t SymbolManager::last_seq_num(uint32_t symbol_id) const {
+    return slot(symbol_id).book.get_last_seq_num();
+}
+
+void SymbolManager::set_last_seq_num(uint32_t symbol_id, uint32_t seq) {
+    slot(symbol_id).book.set_last_seq_num(seq);
+}
+
+// ── Fill callback ─────────────────────────────────────────────────────────────
+// Only this symbol's fill thread writes pnl_work_[id] and pnl_[id], so the
+// update is plain integer arithmetic and one seqlock store. The resulting
+// state is then journalled: one record stored into the map.
 
-    double expected = total_pnl_.load(std::memory_order_relaxed);
-    while (!total_pnl_.compare_exchange_weak(
-               expected, expected + realized,
-               std::memory_order_release,
-               std::memory_order_relaxed)) {}
+void SymbolManager::on_fill(uint32_t symbol_id, SIDE side,
+                             uint32_t qty, int32_t price) {
+    SymbolPnl& p      = pnl_work_[symbol_id];
+    int32_t    delta  = side == SIDE::BUY ? static_cast<int32_t>(qty) : -static_cast<int32_t>(qty);
+    int64_t    value  = static_cast<int64_t>(delta) * price;
+    int32_t    old    = p.position;
+    int32_t    next   = old + delta;
+
+    p.cash -= value;
+    if (old == 0 || (old > 0) == (delta > 0))        // opening or adding
+        p.open_cost += value;
+    else if (std::abs(delta) <= std::abs(old))       // reducing, pro rata
+        p.open_cost -= p.open_cost * std::abs(delta) / std::abs(old);
+    else                                             // flipped through flat
+        p.open_cost = static_cast<int64_t>(next) * price;
+    p.position = next;
+
+    position_[symbol_id].store(next, std::memory_order_release);
+    pnl_[symbol_id].store(p);
+    journal_.append(symbol_id, p.position, p.cash, p.open_cost);
+    notify(1u << symbol_id);
 }
 
 // ── Per-symbol reads ──────────────────────────────────────────────────────────
-// All memory_order_acquire: guarantees we see all writes the MD thread
-// did before its memory_order_release store.
+// Top of book comes from the slot's seqlock: one consistent record, read
+// again if the MD thread was mid-update. Callers that need more than one
+// field should use top_of_book() rather than the single-field getters.
+
+TopOfBook SymbolManager::top_of_book(uint32_t id) const {
+    return tob_[id].load();
+}
 
 int32_t SymbolManager::best_bid_price(uint32_t id) const {
-    return slot(id).best_bid_price.load(std::memory_order_acquire);
+    return tob_[id].load().bid_price;
 }
 
 int32_t SymbolManager::best_ask_price(uint32_t id) const {
-    return slot(id).best_ask_price.load(std::memory_order_acquire);
+    return tob_[id].load().ask_price;
 }
 
 uint32_t SymbolManager::best_bid_qty(uint32_t id) const {
-    return slot(id).best_bid_qty.load(std::memory_order_acquire);
+    return tob_[id].load().bid_qty;
 }
 
 uint32_t SymbolManager::best_ask_qty(uint32_t id) const {
-    return slot(id).best_ask_qty.load(std::memory_order_acquire);
+    return tob_[id].load().ask_qty;
 }
 
 int32_t SymbolManager::get_position(uint32_t id) const {
-    return slot(id).position.load(std::memory_order_acquire);
+    return position_[id].load(std::memory_order_acquire);
 }
 
 bool SymbolManager::would_breach_limit(uint32_t symbol_id,
                                         SIDE side, int32_t qty) const {
     int32_t pos = get_position(symbol_id);
     int32_t new_pos = (side == SIDE::BUY) ? pos + qty : pos - qty;
-    return std::abs(new_pos) > POSITION_LIMIT;
+    return std::abs(new_pos) > position_limit_[symbol_id];
 }
 
 // ── Snapshot ──────────────────────────────────────────────────────────────────
-// Reads all 13 atomic caches in one pass. Individual reads are not
-// atomically consistent with each other (no lock taken), but this is
-// acceptable: the strategy re-validates before sending any order.
+// Reads the 11 ETF legs' caches in one pass under epoch_seq_, retrying if
+// the MD thread published in between, so every leg is from one epoch.
+// A retry costs one more pass; publication is a handful of stores.
+// Stale symbols read as empty, so they show up as missing legs.
 // On x86 the entire snapshot takes ~50 ns — far faster than a mutex.
 
 ArbSnapshot SymbolManager::snapshot() const {
-    ArbSnapshot snap{};
-    snap.nav_ask              = 0;
-    snap.nav_bid              = 0;
-    snap.any_dorm_ask_missing = false;
-    snap.any_dorm_bid_missing = false;
+    ArbSnapshot snap;
+    uint32_t    seq;
+    do {
+        seq = epoch_seq_.load(std::memory_order_acquire);
+        if (seq & 1) continue;
+        read_legs(snap);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) || epoch_seq_.load(std::memory_order_relaxed) != seq);
+    return snap;
+}
 
-    for (size_t i = 0; i < DORM_IDS.size(); ++i) {
-        const auto& s = slot(DORM_IDS[i]);
+void SymbolManager::read_legs(ArbSnapshot& snap) const {
+    BasketView<MAX_BASKET_LEGS>& legs = snap.legs;
+    legs.clear();
+    legs.count = leg_count_;
+    for (size_t i = 0; i < leg_count_; ++i) {
+        uint32_t  id  = leg_id_[i];
+        TopOfBook tob = tob_[id].load();
+        legs.bid_price[i] = tob.bid_price;
+        legs.ask_price[i] = tob.ask_price;
+        legs.bid_qty[i]   = static_cast<int32_t>(tob.bid_qty);
+        legs.ask_qty[i]   = static_cast<int32_t>(tob.ask_qty);
+        legs.position[i]  = position_[id].load(std::memory_order_acquire);
+        legs.limit[i]     = position_limit_[id];
+        legs.weight[i]    = leg_weight_[i];
+    }
 
-        int32_t  bid_px  = s.best_bid_price.load(std::memory_order_acquire);
-        int32_t  ask_px  = s.best_ask_price.load(std::memory_order_acquire);
-        uint32_t bid_qty = s.best_bid_qty  .load(std::memory_order_acquire);
-        uint32_t ask_qty = s.best_ask_qty  .load(std::memory_order_acquire);
-        int32_t  pos     = s.position      .load(std::memory_order_acquire);
+    // NAV, masks and edges were derived when the legs were published
+    NavState nav              = nav_.load();
+    snap.cash                 = cash_;
+    snap.nav_ask              = nav.nav_ask;
+    snap.nav_bid              = nav.nav_bid;
+    snap.ask_missing_mask     = nav.ask_missing;
+    snap.bid_missing_mask     = nav.bid_missing;
+    snap.any_dorm_ask_missing = nav.ask_missing != 0;
+    snap.any_dorm_bid_missing = nav.bid_missing != 0;
+    snap.edges                = { nav.creation_edge, nav.redemption_edge };
+
+    TopOfBook undy_tob       = tob_[etf_id_].load();
+    snap.undy_best_bid_price = undy_tob.bid_price;
+    snap.undy_best_ask_price = undy_tob.ask_price;
+    snap.undy_best_bid_qty   = undy_tob.bid_qty;
+    snap.undy_best_ask_qty   = undy_tob.ask_qty;
+    snap.undy_position       = position_[etf_id_].load(std::memory_order_acquire);
+
+    snap.epoch          = epoch_  .load(std::memory_order_relaxed);
+    snap.feed_timestamp = feed_ts_.load(std::memory_order_relaxed);
+}
 
-        snap.dorms[i] = { bid_px, ask_px, bid_qty, ask_qty, pos };
+// ── Book anomalies ────────────────────────────────────────────────────────────
 
-        if (ask_px == 0) snap.any_dorm_ask_missing = true;
-        else             snap.nav_ask += ask_px;
+const BookAnomalies& SymbolManager::anomalies(uint32_t symbol_id) const {
+    return slot(symbol_id).anomalies;
+}
 
-        if (bid_px == 0) snap.any_dorm_bid_missing = true;
-        else             snap.nav_bid += bid_px;
-    }
+// ── PnL ───────────────────────────────────────────────────────────────────────
 
-    const auto& undy = slot(SYM_UNDY);
-    snap.undy_best_bid_price = undy.best_bid_price.load(std::memory_order_acquire);
-    snap.undy_best_ask_price = undy.best_ask_price.load(std::memory_order_acquire);
-    snap.undy_best_bid_qty   = undy.best_bid_qty  .load(std::memory_order_acquire);
-    snap.undy_best_ask_qty   = undy.best_ask_qty  .load(std::memory_order_acquire);
-    snap.undy_position       = undy.position      .load(std::memory_order_acquire);
+SymbolPnl SymbolManager::symbol_pnl(uint32_t symbol_id) const {
+    return pnl_[symbol_id].load();
+}
 
-    return snap;
+PnlSummary SymbolManager::symbol_pnl_summary(uint32_t symbol_id) const {
+    SymbolPnl p = pnl_[symbol_id].load();
+    PnlSummary s{ p.cash + p.open_cost, 0 };
+    if (p.position == 0) return s;
+
+    TopOfBook tob  = tob_[symbol_id].load();
+    int32_t   mark = p.position > 0 ? tob.bid_price : tob.ask_price;
+    if (mark != 0) s.unrealized = static_cast<int64_t>(p.position) * mark - p.open_cost;
+    return s;
 }
 
-// ── PnL ───────────────────────────────────────────────────────────────────────
+PnlSummary SymbolManager::pnl() const {
+    PnlSummary total{0, 0};
+    for (uint32_t id : config_.ids()) {
+        PnlSummary s = symbol_pnl_summary(id);
+        total.realized   += s.realized;
+        total.unrealized += s.unrealized;
+    }
+    return total;
+}
+
+double SymbolManager::avg_entry_price(uint32_t symbol_id) const {
+    SymbolPnl p = pnl_[symbol_id].load();
+    return p.position ? static_cast<double>(p.open_cost) / p.position : 0.0;
+}
 
 double SymbolManager::get_total_pnl() const {
-    return total_pnl_.load(std::memory_order_acquire);
+    return static_cast<double>(pnl().total());
 }
 
 bool SymbolManager::pnl_near_limit() const {
     return get_total_pnl() <= PNL_WARN_LEVEL;
-}
\ No newline at end of file
+}
@@ -2,6 +2,7 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 #include <cstdint>
@@ -9,99 +10,183 @@
 
 #include "orderbook.h"
 #include "messages.h"
+#include "seqlock.h"
+#include "basket_view.h"
+#include "symbol_config.h"
+#include "position_journal.h"
+
+// ── TopOfBook ─────────────────────────────────────────────────────────────────
+// One symbol's best bid and ask, published as a single record through a
+// seqlock so price and qty always come from the same book update.
+// Prices of 0 mean the side is empty.
+struct TopOfBook {
+    int32_t  bid_price;
+    uint32_t bid_qty;
+    int32_t  ask_price;
+    uint32_t ask_qty;
+};
+
+// ── PnL ──────────────────────────────────────────────────────────────────────
+// Accounting is exact in int64 price ticks × lots.
+//   cash       Σ sells qty × price − Σ buys qty × price
+//   open_cost  entry cost of the open position, signed like the position;
+//              reduced pro rata as it is closed, reset on a flip
+// so realized = cash + open_cost and unrealized = position × mark − open_cost.
+// Their sum, cash + position × mark, does not depend on how open_cost
+// rounds when part of a position is closed.
+struct SymbolPnl {
+    int32_t position;
+    int64_t cash;
+    int64_t open_cost;
+};
+
+struct PnlSummary {
+    int64_t realized;
+    int64_t unrealized;   // marked to the live top of book
+    int64_t total() const { return realized + unrealized; }
+};
 
-// ── Symbol ID constants ───────────────────────────────────────────────────────
-
-static constexpr uint32_t SYM_GOLD = 1;
-static constexpr uint32_t SYM_BLUE = 2;
-static constexpr uint32_t SYM_KNAN = 3;
-static constexpr uint32_t SYM_STED = 4;
-static constexpr uint32_t SYM_FISH = 5;
-static constexpr uint32_t SYM_DILN = 6;
-static constexpr uint32_t SYM_SORN = 7;
-static constexpr uint32_t SYM_RYAN = 8;
-static constexpr uint32_t SYM_LYON = 9;
-static constexpr uint32_t SYM_WLSH = 10;
-static constexpr uint32_t SYM_LEWI = 11;
-static constexpr uint32_t SYM_BDIN = 12;
-static constexpr uint32_t SYM_UNDY = 13;
-
-static constexpr std::array<uint32_t, 10> DORM_IDS = {
-    SYM_KNAN, SYM_STED, SYM_FISH, SYM_DILN, SYM_SORN,
-    SYM_RYAN, SYM_LYON, SYM_WLSH, SYM_LEWI, SYM_BDIN
+// ── ArbEdges ─────────────────────────────────────────────────────────────────
+// Creation edge: ETF best bid − NAV at the leg asks (buy basket, sell ETF).
+// Redemption edge: NAV at the leg bids − ETF best ask (buy ETF, sell basket).
+// NAV is per creation unit: Σ weight × price over the legs, plus cash.
+// NO_EDGE when a leg needed for that direction has no price.
+struct ArbEdges {
+    static constexpr int32_t NO_EDGE = INT32_MIN;
+    int32_t creation;
+    int32_t redemption;
 };
 
 // ── ArbSnapshot ───────────────────────────────────────────────────────────────
 // All data needed to evaluate one ETF arb opportunity, read in a single pass
-// from the atomic caches. No locks taken. Individual reads are not
-// guaranteed to be mutually consistent (prices can shift between reads),
-// but the arb edge is large enough that this is acceptable in practice.
-// The strategy must re-validate before firing orders anyway.
+// from the per-symbol caches. No locks taken. Every leg's book state is as
+// of the same publication epoch — one processed market data batch — so the
+// NAV never mixes legs from different packets. Positions are read alongside
+// and are not part of the epoch.
 struct ArbSnapshot {
-    struct DormData {
-        int32_t  best_bid_price;
-        int32_t  best_ask_price;
-        uint32_t best_bid_qty;
-        uint32_t best_ask_qty;
-        int32_t  position;
-    };
-    std::array<DormData, 10> dorms;  // indexed 0–9, matching DORM_IDS order
+    // Basket legs in config order, as a struct of arrays for the basket
+    // kernels. Empty sides have price 0 and qty 0.
+    BasketView<MAX_BASKET_LEGS> legs;
 
+    // The basket's ETF (UNDY in the default universe)
     int32_t  undy_best_bid_price;
     int32_t  undy_best_ask_price;
     uint32_t undy_best_bid_qty;
     uint32_t undy_best_ask_qty;
     int32_t  undy_position;
 
-    // Derived NAV values computed during snapshot
-    int32_t nav_ask;               // sum of all 10 dorm best asks
-    int32_t nav_bid;               // sum of all 10 dorm best bids
-    bool    any_dorm_ask_missing;  // true if any dorm has no ask
-    bool    any_dorm_bid_missing;  // true if any dorm has no bid
+    // Derived values, maintained incrementally by the MD thread and
+    // published with the same epoch as the legs
+    int32_t cash;                  // cash per creation unit, included in both NAVs
+    int32_t nav_ask;               // cash + Σ weight × best ask over the legs present
+    int32_t nav_bid;               // cash + Σ weight × best bid over the legs present
+    bool    any_dorm_ask_missing;  // true if any leg has no ask
+    bool    any_dorm_bid_missing;  // true if any leg has no bid
+    uint64_t ask_missing_mask;     // bit i: leg i has no ask
+    uint64_t bid_missing_mask;     // bit i: leg i has no bid
+    ArbEdges edges;
+
+    uint64_t epoch;                // publication epoch the books are from
+    uint64_t feed_timestamp;       // md timestamp of that epoch's last message
+};
+
+// ── WaitMode ─────────────────────────────────────────────────────────────────
+// How a consumer waits in SymbolManager::wait_for_change().
+enum class WaitMode : uint8_t {
+    BUSY_POLL,        // spin on the change counter — for a pinned, isolated core
+    SPIN_THEN_PARK,   // spin briefly, then sleep on a futex until woken
 };
 
 // ── SymbolManager ─────────────────────────────────────────────────────────────
 //
-// Owns one OrderBook and one atomic top-of-book cache per symbol (13 total).
+// Owns one OrderBook and one atomic top-of-book cache per symbol of the
+// SymbolConfig it is built from, plus the basket NAV for its ETF.
 //
 // Threading model:
 //   Market data thread — calls on_new_order / on_delete / on_modify / on_trade
 //                        which update the full OrderBook, then write atomics.
 //   Strategy thread   — reads atomics via snapshot() or direct getters.
-//   Fill thread       — calls on_fill(), which updates atomic positions.
+//   Fill thread       — calls on_fill(), which updates positions and PnL.
+//                        At most one thread fills any given symbol.
 //
-// No mutexes, no kernel calls. All shared state is accessed via
-// std::atomic with relaxed or release/acquire ordering:
+// No mutexes. All shared state is accessed via std::atomic with relaxed or
+// release/acquire ordering:
 //   - Writers use memory_order_release  (all prior writes visible to reader)
 //   - Readers use memory_order_acquire  (sees all writes before the release)
+// The one kernel call: a consumer parked in wait_for_change() sleeps on a
+// futex, and while one is parked every notify() (end of an MD batch, each
+// fill, wake()) makes a FUTEX_WAKE syscall. With no one parked, notify()
+// is plain atomics.
 //
-// Position limit is 9 (one below the exchange hard limit of 10).
+// Symbol ids, ticks, position limits and the basket come from the config
+// and are fixed at construction.
 
 class SymbolManager {
 public:
-    static constexpr int32_t POSITION_LIMIT  = 9;
     static constexpr double  PNL_WARN_LEVEL  = -4500.0;
 
-    SymbolManager();
+    explicit SymbolManager(const SymbolConfig& config = SymbolConfig::defaults());
+
+    const SymbolConfig& config() const { return config_; }
+    bool has_symbol(uint32_t symbol_id) const { return config_.has(symbol_id); }
 
     // ── Market data thread ───────────────────────────────────────────────────
     // Update the full order book, then flush top-of-book into the atomics.
     // Only ever called from the market data thread — no sharing of OrderBook.
+    // on_new_order / on_trade return whether the order rests in the book
+    // afterwards, so the caller's order routing can follow it.
 
-    void on_new_order   (uint32_t symbol_id, const new_order*    msg);
+    bool on_new_order   (uint32_t symbol_id, const new_order*    msg);
     void on_delete_order(uint32_t symbol_id, const delete_order* msg);
     void on_modify_order(uint32_t symbol_id, const modify_order* msg);
-    void on_trade       (uint32_t symbol_id, const trade*        msg);
+    bool on_trade       (uint32_t symbol_id, const trade*        msg);
+
+    // ── Position journal ─────────────────────────────────────────────────────
+    // Positions, entry prices and realized PnL are journalled on every fill
+    // (see position_journal.h). open_journal() restores them from the file
+    // and keeps appending to it; call before trading starts. False if the
+    // journal cannot be used, or if there is no journal yet but the
+    // pre-journal `legacy_positions` file still exists — its positions have
+    // no entry prices to carry over. sync_journal() flushes it to disk.
+
+    bool open_journal(const std::string& path, const std::string& legacy_positions = "");
+    void sync_journal();
+
+    // ── Batch publication ────────────────────────────────────────────────────
+    // The MD thread brackets each processed packet batch with begin_batch()
+    // and end_batch(). Top-of-book changes inside the batch are held back
+    // and published together as one epoch at end_batch(); a batch that
+    // changed no top of book publishes nothing. Outside a batch every
+    // update is published immediately as its own epoch.
+
+    void begin_batch();
+    void end_batch(uint64_t feed_timestamp);
+    uint64_t epoch() const;
+
+    // Call when a snapshot arrives for a symbol to clear stale orders.
+    // Clears in place: the book keeps its allocated capacity.
+    void reset_book(uint32_t symbol_id);
 
-    void save_positions(const std::string& path) const;
-    void load_positions(const std::string& path);
+    // Load a snapshot's orders into a (reset) book in one batch
+    void load_snapshot(uint32_t symbol_id, const new_order* const* orders, size_t count);
 
-    // Call when a snapshot arrives for a symbol to clear stale orders
-    void reset_book(uint32_t symbol_id);
+    // ── Sequence recovery ────────────────────────────────────────────────────
+    // A stale slot has missed market data. Its top of book reads as empty
+    // (so snapshot() reports the symbol untradeable) and is not republished
+    // until the listener has rebuilt the book and calls clear_stale().
+
+    void mark_stale (uint32_t symbol_id);
+    void clear_stale(uint32_t symbol_id);
+    bool is_stale   (uint32_t symbol_id) const;
+
+    // Last md seq_num applied to the symbol's book — market data thread only
+    uint32_t last_seq_num    (uint32_t symbol_id) const;
+    void     set_last_seq_num(uint32_t symbol_id, uint32_t seq);
 
     // ── Fill callback ────────────────────────────────────────────────────────
-    // Called when one of our orders is filled.
-    // Updates atomic position and global PnL via a CAS loop (no kernel call).
+    // Called when one of our orders is filled. Updates the symbol's position
+    // and publishes its PnL record through its seqlock (no kernel call).
+    // Fills for one symbol must all come from the same thread.
 
     void on_fill(uint32_t symbol_id, SIDE side, uint32_t qty, int32_t price);
 
@@ -110,64 +195,176 @@ public:
 
     ArbSnapshot snapshot() const;
 
+    // Current creation/redemption edges in one atomic load — a cheap check
+    // before taking a full snapshot()
+    ArbEdges edges() const;
+
+    // Consistent bid/ask record; retries internally on a torn read
+    TopOfBook top_of_book(uint32_t symbol_id) const;
+
     int32_t  best_bid_price(uint32_t symbol_id) const;
     int32_t  best_ask_price(uint32_t symbol_id) const;
     uint32_t best_bid_qty  (uint32_t symbol_id) const;
     uint32_t best_ask_qty  (uint32_t symbol_id) const;
     int32_t  get_position  (uint32_t symbol_id) const;
 
-    // Returns true if adding `qty` on `side` would exceed POSITION_LIMIT
+    // Configured largest |position| for the symbol
+    int32_t position_limit(uint32_t symbol_id) const { return position_limit_[symbol_id]; }
+
+    // Returns true if adding `qty` on `side` would exceed position_limit()
     bool would_breach_limit(uint32_t symbol_id, SIDE side, int32_t qty) const;
 
+    // ── Book anomalies ───────────────────────────────────────────────────────
+    // Per-symbol feed anomaly counters, kept across book resets. Lock-free
+    // to read from any thread; the PnL monitor prints them off the MD thread.
+
+    const BookAnomalies& anomalies(uint32_t symbol_id) const;
+
+    // ── Change notification ──────────────────────────────────────────────────
+    // Every publication (MD thread) and every fill bumps a change counter
+    // and ORs the affected symbols into a dirty mask. One consumer thread
+    // waits on the counter and takes the mask to see which symbols moved.
+    // Publishers only make a wake syscall when a consumer is parked.
+
+    uint32_t change_seq() const;
+
+    // Bump change_seq() without marking a symbol — wakes waiters for events
+    // from outside the books, such as queued order-entry responses
+    void wake() { notify(0); }
+
+    // Symbols changed since the last call, bit per symbol id; clears them
+    uint32_t take_changes();
+
+    // Wait until change_seq() differs from `seen` or `timeout` passes.
+    // Returns the current change_seq().
+    uint32_t wait_for_change(uint32_t seen, WaitMode mode,
+                             std::chrono::microseconds timeout) const;
+
     // ── PnL ──────────────────────────────────────────────────────────────────
-    double get_total_pnl()  const;
-    bool   pnl_near_limit() const;
+    // Open positions are marked where they could be closed: longs at the
+    // best bid, shorts at the best ask. With that side empty (or the book
+    // stale) the position is held at its entry cost.
+
+    SymbolPnl  symbol_pnl(uint32_t symbol_id) const;
+    PnlSummary symbol_pnl_summary(uint32_t symbol_id) const;
+    PnlSummary pnl() const;                 // summed over every symbol
+    double     avg_entry_price(uint32_t symbol_id) const;
+
+    double get_total_pnl()  const;          // pnl().total()
+    bool   pnl_near_limit() const;          // realized + unrealized
 
 private:
+    // ── Layout ───────────────────────────────────────────────────────────────
+    // Shared state is grouped by the thread that writes it, each group
+    // starting on its own cache line, so a store by one thread never
+    // invalidates a line holding another thread's data:
+    //   MD → strategy    epoch, basket state and every symbol's top of book,
+    //                    packed densely so the 11-leg scan touches ~7 lines
+    //   fill → strategy  positions, plus each symbol's int64 cash and
+    //                    open_cost behind a SeqLock<SymbolPnl>
+    //   any → consumer   change notification
+    //   fill only        the fill thread's working SymbolPnl copies and the
+    //                    position journal
+    //   MD only          books and publication bookkeeping (slots, heap)
+
     // ── Per-symbol slot ───────────────────────────────────────────────────────
-    // OrderBook is only ever written by the market data thread so it needs
-    // no synchronisation. The four atomic top-of-book values are the only
-    // shared state between the MD thread and the strategy thread.
-    struct SymbolSlot {
+    // Market data thread state for one symbol. Heap-allocated and aligned so
+    // no other allocation shares its first line.
+    struct alignas(64) SymbolSlot {
+        // Anomaly counters the book records into — declared before the
+        // book, which holds a pointer to them
+        BookAnomalies anomalies;
+
         // Full order book — market data thread only
         OrderBook book;
 
-        // Top-of-book cache — written by MD thread, read by strategy thread.
-        // Stored as atomics so the strategy can read without any lock.
-        // Prices of 0 mean the side is empty.
-        std::atomic<int32_t>  best_bid_price{0};
-        std::atomic<uint32_t> best_bid_qty{0};
-        std::atomic<int32_t>  best_ask_price{0};
-        std::atomic<uint32_t> best_ask_qty{0};
+        // Set by the MD thread on a sequence gap, cleared once the book
+        // has been rebuilt from a snapshot.
+        std::atomic<bool>     stale{false};
 
-        // Our net position in this symbol.
-        // Written by fill callback, read by strategy thread.
-        std::atomic<int32_t>  position{0};
+        // Last record stored into tob_ — MD thread only, for NAV deltas
+        TopOfBook             published{};
 
-        explicit SymbolSlot(uint32_t id) : book(id) {}
+        SymbolSlot(uint32_t id, int32_t tick) : book(id, tick, &anomalies) {}
 
         // Non-copyable, non-movable (atomics)
         SymbolSlot(const SymbolSlot&)            = delete;
         SymbolSlot& operator=(const SymbolSlot&) = delete;
 
-        // Called by the MD thread after every book update to flush
-        // the latest top-of-book into the atomics.
-        void flush_top_of_book() {
-            best_bid_price.store(book.get_best_bid_price(), std::memory_order_release);
-            best_bid_qty  .store(book.get_best_bid_qty(),   std::memory_order_release);
-            best_ask_price.store(book.get_best_ask_price(), std::memory_order_release);
-            best_ask_qty  .store(book.get_best_ask_qty(),   std::memory_order_release);
+        // Record to publish for this slot. A stale book is being rebuilt
+        // and reads as empty.
+        TopOfBook current_top() const {
+            if (stale.load(std::memory_order_relaxed)) return {};
+            return { book.get_best_bid_price(), book.get_best_bid_qty(),
+                     book.get_best_ask_price(), book.get_best_ask_qty() };
         }
     };
 
+    // NAV sums (starting from the cash component) and missing-leg masks,
+    // updated by delta in publish() as leg and ETF tops change
+    struct NavState {
+        int32_t  nav_bid;
+        int32_t  nav_ask;
+        uint64_t bid_missing;
+        uint64_t ask_missing;
+        int32_t  creation_edge;
+        int32_t  redemption_edge;
+    };
+
+    // ── Fixed at construction ────────────────────────────────────────────────
+    // Read by every thread, never written after the constructor
+    SymbolConfig                               config_;
+    std::array<int32_t, MAX_SYMBOLS>           position_limit_{};
+    uint32_t                                   etf_id_    = 0;
+    size_t                                     leg_count_ = 0;
+    std::array<uint32_t, MAX_BASKET_LEGS>      leg_id_{};
+    std::array<int32_t, MAX_BASKET_LEGS>       leg_weight_{};
+    int32_t                                    cash_      = 0;
+
+    // ── MD thread → strategy ─────────────────────────────────────────────────
+    // epoch_seq_ is a seqlock over all of it: odd while publish() is
+    // storing, so snapshot() can retry until it reads one epoch. edges_
+    // packs both edges into one word for edges().
+    alignas(64) std::atomic<uint32_t> epoch_seq_{0};
+    std::atomic<uint64_t>              epoch_{0};
+    std::atomic<uint64_t>              feed_ts_{0};
+    std::atomic<uint64_t>              edges_{0};
+    SeqLock<NavState>                  nav_;
+    std::array<SeqLock<TopOfBook>, MAX_SYMBOLS> tob_;   // by symbol id, index 0 unused
+
+    // ── Fill thread → strategy ───────────────────────────────────────────────
+    // Our net position per symbol, and its PnL record behind a seqlock with
+    // the fill thread as the single writer. Totals are summed on read.
+    alignas(64) std::array<std::atomic<int32_t>, MAX_SYMBOLS> position_{};
+    std::array<SeqLock<SymbolPnl>, MAX_SYMBOLS>                pnl_;
+
+    // ── Change notification ──────────────────────────────────────────────────
+    alignas(64) mutable std::atomic<uint32_t> change_seq_{0};   // futex word (waiters need it non-const)
+    std::atomic<uint32_t>                     changed_mask_{0};
+    mutable std::atomic<uint32_t>             parked_{0};       // consumers asleep on change_seq_
+
+    // ── Fill thread only ─────────────────────────────────────────────────────
+    alignas(64) std::array<SymbolPnl, MAX_SYMBOLS> pnl_work_{};   // running copy of pnl_
+    PositionJournal                                journal_;
+
+    // ── MD thread only ───────────────────────────────────────────────────────
+    alignas(64) bool       in_batch_ = false;
+    uint32_t               dirty_    = 0;   // bit per symbol id
+    NavState               nav_work_{};     // running copy of nav_
+    std::array<int8_t, MAX_SYMBOLS> dorm_index_;   // symbol id → basket leg, -1 if none
+
     //std::unordered_map<uint32_t, std::unique_ptr<SymbolSlot>> slots_;
-    std::array<std::unique_ptr<SymbolSlot>, 14> slots_; //index 0 unused
+    std::array<std::unique_ptr<SymbolSlot>, MAX_SYMBOLS> slots_; // configured ids only
+
+    void notify(uint32_t mask);
 
-    // Global PnL stored as an atomic double.
-    // Updated via CAS loop in on_fill() — no kernel call.
-    std::atomic<double> total_pnl_{0.0};
+    void apply_leg(int8_t dorm, const TopOfBook& prev, const TopOfBook& next);
+    void refresh_edges();
 
-    std::array<double, 14> avg_entry_price_{};
+    // Publish `symbol_id`'s top of book now, or at end_batch() if in a batch
+    void touch(uint32_t symbol_id);
+    void publish(uint32_t mask, uint64_t feed_timestamp);
+    void read_legs(ArbSnapshot& snap) const;
 
     // Safe slot accessor
     SymbolSlot&       slot(uint32_t symbol_id);
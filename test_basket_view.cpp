@@ -0,0 +1,120 @@
+#include "basket_view.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+// Reference results straight from the definitions
+static BasketSums reference_sums(const BasketView<64>& v) {
+    BasketSums s{0, 0, 0, 0};
+    for (size_t i = 0; i < v.count; ++i) {
+        s.nav_bid += v.weight[i] * v.bid_price[i];
+        s.nav_ask += v.weight[i] * v.ask_price[i];
+        if (v.bid_price[i] == 0) s.bid_missing |= uint64_t{1} << i;
+        if (v.ask_price[i] == 0) s.ask_missing |= uint64_t{1} << i;
+    }
+    return s;
+}
+
+static int32_t reference_units(const BasketView<64>& v, bool creation) {
+    int32_t units = INT32_MAX;
+    for (size_t i = 0; i < v.count; ++i) {
+        int32_t lots = creation ? v.ask_qty[i] : v.bid_qty[i];
+        int32_t room = creation ? v.limit[i] - v.position[i] : v.limit[i] + v.position[i];
+        units = std::min(units, std::min(lots, room) / v.weight[i]);
+    }
+    return units;
+}
+
+static bool same(const BasketSums& a, const BasketSums& b) {
+    return a.nav_bid == b.nav_bid && a.nav_ask == b.nav_ask
+        && a.bid_missing == b.bid_missing && a.ask_missing == b.ask_missing;
+}
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    std::cout << "AVX2 " << (basket_avx2_available() ? "available" : "not available — scalar only") << "\n";
+
+    // ── Test 1: hand-checked basket ───────────────────────────────────────
+    {
+        BasketView<16> v;
+        v.clear();
+        v.count = 3;
+        int32_t bid[] = {99, 0, 48}, ask[] = {101, 52, 0}, w[] = {1, 2, 3};
+        int32_t bq[]  = {7, 0, 9},   aq[]  = {5, 8, 0},   pos[] = {0, 3, -2};
+        for (size_t i = 0; i < 3; ++i) {
+            v.bid_price[i] = bid[i]; v.ask_price[i] = ask[i]; v.weight[i] = w[i];
+            v.bid_qty[i]   = bq[i];  v.ask_qty[i]   = aq[i];  v.position[i] = pos[i];
+            v.limit[i]     = 9;
+        }
+        BasketSums s = v.sums();
+        check("nav sums weighted",      s.nav_bid == 99 + 0 + 144 && s.nav_ask == 101 + 104 + 0);
+        check("missing masks",          s.bid_missing == 0b010 && s.ask_missing == 0b100);
+        check("empty side caps units",  v.creation_units() == 0 && v.redemption_units() == 0);
+
+        v.ask_qty[2] = 12; v.bid_qty[1] = 20;
+        // creation: min(5,9)/1, min(8,6)/2, min(12,11)/3 → 3
+        // redemption: min(7,9)/1, min(20,12)/2, min(9,7)/3 → 2
+        check("creation units",         v.creation_units() == 3);
+        check("redemption units",       v.redemption_units() == 2);
+
+        v.position[0] = 12;
+        check("over limit gives no units", v.creation_units() < 0);
+    }
+
+    // ── Test 2: scalar and AVX2 agree with the reference ──────────────────
+    {
+        std::mt19937 rng(18);
+        bool sums_ok = true, units_ok = true, kernels_agree = true;
+        for (int round = 0; round < 20000; ++round) {
+            BasketView<64> v;
+            v.clear();
+            v.count = rng() % 65;
+            for (size_t i = 0; i < v.count; ++i) {
+                v.bid_price[i] = rng() % 8 ? 1 + static_cast<int32_t>(rng() % 5000) : 0;
+                v.ask_price[i] = rng() % 8 ? 1 + static_cast<int32_t>(rng() % 5000) : 0;
+                v.bid_qty[i]   = static_cast<int32_t>(rng() % 100);
+                v.ask_qty[i]   = static_cast<int32_t>(rng() % 100);
+                v.position[i]  = static_cast<int32_t>(rng() % 41) - 20;
+                v.limit[i]     = 1 + static_cast<int32_t>(rng() % 20);
+                v.weight[i]    = 1 + static_cast<int32_t>(rng() % 7);
+            }
+            size_t lanes = v.lanes();
+
+            BasketSums ref = reference_sums(v);
+            BasketSums sc  = basket_sums_scalar(v.weight.data(), v.bid_price.data(),
+                                                v.ask_price.data(), lanes, v.count);
+            if (!same(sc, ref) || !same(v.sums(), ref)) sums_ok = false;
+
+            for (bool creation : {true, false}) {
+                const int32_t* lots = creation ? v.ask_qty.data() : v.bid_qty.data();
+                int32_t sign = creation ? +1 : -1;
+                int32_t ref_units = reference_units(v, creation);
+                int32_t sc_units  = basket_max_units_scalar(lots, v.position.data(), v.limit.data(),
+                                                            v.weight.data(), sign, lanes);
+                int32_t units     = creation ? v.creation_units() : v.redemption_units();
+                if (sc_units != ref_units || units != ref_units) units_ok = false;
+
+                if (basket_avx2_available()
+                    && basket_max_units_avx2(lots, v.position.data(), v.limit.data(),
+                                             v.weight.data(), sign, lanes) != sc_units)
+                    kernels_agree = false;
+            }
+            if (basket_avx2_available()
+                && !same(basket_sums_avx2(v.weight.data(), v.bid_price.data(),
+                                          v.ask_price.data(), lanes, v.count), sc))
+                kernels_agree = false;
+        }
+        check("sums match reference",   sums_ok);
+        check("units match reference",  units_ok);
+        check("avx2 matches scalar",    kernels_agree);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#include "flat_hash_map.h"
+#include <iostream>
+#include <random>
+#include <unordered_map>
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // ── Test 1: basic insert / find / erase ───────────────────────────────
+    {
+        FlatHashMap<int> m;
+        m.insert(42, 1);
+        m.insert(43, 2);
+        check("find hit",          m.find(42) && *m.find(42) == 1);
+        check("find miss",         m.find(44) == nullptr);
+        m.insert(42, 7);
+        check("insert overwrites", *m.find(42) == 7 && m.size() == 2);
+        check("erase hit",         m.erase(42) && !m.contains(42));
+        check("erase miss",        !m.erase(42));
+        check("neighbour intact",  *m.find(43) == 2 && m.size() == 1);
+    }
+
+    // ── Test 2: random ops match std::unordered_map ───────────────────────
+    // Sequential ids with a churning live set, like an exchange feed.
+    {
+        FlatHashMap<uint64_t> m(4);
+        std::unordered_map<uint64_t, uint64_t> ref;
+        std::mt19937_64 rng(7);
+        uint64_t next_id = 1000;
+        bool same = true;
+
+        for (int i = 0; i < 200000 && same; ++i) {
+            uint64_t r = rng() % 10;
+            if (r < 5) {
+                uint64_t id = next_id++;
+                m.insert(id, id * 3);
+                ref[id] = id * 3;
+            } else {
+                uint64_t id = 1000 + rng() % (next_id - 999);
+                bool a = m.erase(id);
+                bool b = ref.erase(id) > 0;
+                same &= a == b;
+            }
+            if (i % 1000 == 0) {
+                for (auto& kv : ref) {
+                    const uint64_t* v = m.find(kv.first);
+                    if (!v || *v != kv.second) { same = false; break; }
+                }
+            }
+        }
+        check("matches unordered_map", same && m.size() == ref.size());
+
+        size_t visited = 0;
+        m.for_each([&](uint64_t k, uint64_t& v) { if (ref.count(k) && ref[k] == v) ++visited; });
+        check("for_each sees all",     visited == ref.size());
+    }
+
+    // ── Test 3: clear keeps capacity ──────────────────────────────────────
+    {
+        FlatHashMap<int> m(1000);
+        size_t cap = m.capacity();
+        for (int i = 0; i < 500; ++i) m.insert(i, i);
+        m.clear();
+        check("cleared",           m.empty() && !m.contains(10));
+        check("capacity kept",     m.capacity() == cap);
+        m[5] = 9;
+        check("usable after clear", *m.find(5) == 9);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+#include "listener.h"
+#include <iostream>
+
+// Helpers to build minimal market data messages
+new_order make_order(uint64_t oid, uint32_t sym, SIDE side,
+                     int32_t price, uint32_t qty, uint32_t seq) {
+    new_order msg{};
+    msg.header.msg_type = MSG_TYPE::NEW_ORDER;
+    msg.header.seq_num  = seq;
+    msg.order_id        = oid;
+    msg.symbol          = sym;
+    msg.side            = side;
+    msg.price           = price;
+    msg.quantity        = qty;
+    return msg;
+}
+
+trade make_trade(uint64_t oid, int32_t price, uint32_t qty, uint32_t seq) {
+    trade msg{};
+    msg.header.msg_type = MSG_TYPE::TRADE;
+    msg.header.seq_num  = seq;
+    msg.order_id        = oid;
+    msg.price           = price;
+    msg.quantity        = qty;
+    return msg;
+}
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // Route a message the way the listener loop does, then apply it
+    auto feed = [](SymbolManager& sm, OrderRouter& router, auto& msg) {
+        char* buf = reinterpret_cast<char*>(&msg);
+        uint32_t symbol = route_md_message(sm, router, reinterpret_cast<md_header*>(buf));
+        if (symbol) apply_md_message(sm, router, symbol, buf);
+        return symbol;
+    };
+
+    // ── Test 1: a fully traded order stops being routed ───────────────────
+    {
+        SymbolManager sm;
+        OrderRouter   router;
+        auto o = make_order(1, SYM_KNAN, SIDE::BUY, 100, 5, 1);
+        feed(sm, router, o);
+        check("new order routed",        router.find(1) == SYM_KNAN);
+
+        auto t1 = make_trade(1, 100, 2, 2);
+        feed(sm, router, t1);
+        check("partial fill still routed", router.find(1) == SYM_KNAN);
+        check("partial fill rests",      sm.best_bid_qty(SYM_KNAN) == 3);
+
+        auto t2 = make_trade(1, 100, 3, 3);
+        feed(sm, router, t2);
+        check("full fill unrouted",      router.find(1) == OrderRouter::NO_SYMBOL);
+        check("full fill leaves book",   sm.best_bid_price(SYM_KNAN) == 0);
+        check("symbol list empty",       router.symbol_size(SYM_KNAN) == 0);
+
+        auto t3 = make_trade(1, 100, 1, 4);
+        check("late trade not routed",   feed(sm, router, t3) == 0);
+    }
+
+    // ── Test 2: a rejected new order is never routed ──────────────────────
+    {
+        SymbolManager sm;
+        OrderRouter   router;
+        auto zero = make_order(7, SYM_KNAN, SIDE::SELL, 105, 0, 1);
+        feed(sm, router, zero);
+        check("zero qty not routed",     router.find(7) == OrderRouter::NO_SYMBOL);
+
+        auto neg = make_order(8, SYM_KNAN, SIDE::SELL, -1, 4, 2);
+        feed(sm, router, neg);
+        check("negative price not routed", router.find(8) == OrderRouter::NO_SYMBOL);
+        check("nothing routed",          router.size() == 0);
+
+        auto unknown = make_order(9, 9999, SIDE::SELL, 105, 4, 3);
+        check("unknown symbol dropped",  feed(sm, router, unknown) == 0 && router.size() == 0);
+    }
+
+    // ── Test 3: delete unroutes, modify keeps the route ───────────────────
+    {
+        SymbolManager sm;
+        OrderRouter   router;
+        auto a = make_order(20, SYM_STED, SIDE::BUY, 50, 4, 1);
+        auto b = make_order(21, SYM_STED, SIDE::SELL, 55, 4, 2);
+        feed(sm, router, a);
+        feed(sm, router, b);
+
+        modify_order mod{};
+        mod.header.msg_type = MSG_TYPE::MODIFY_ORDER;
+        mod.header.seq_num  = 3;
+        mod.order_id        = 20;
+        mod.side            = SIDE::BUY;
+        mod.quantity        = 6;
+        mod.price           = 51;
+        feed(sm, router, mod);
+        check("modified order routed",   router.find(20) == SYM_STED && sm.best_bid_price(SYM_STED) == 51);
+
+        delete_order del{};
+        del.header.msg_type = MSG_TYPE::DELETE_ORDER;
+        del.header.seq_num  = 4;
+        del.order_id        = 21;
+        feed(sm, router, del);
+        check("deleted order unrouted",  router.find(21) == OrderRouter::NO_SYMBOL);
+        check("one order left",          router.symbol_size(SYM_STED) == 1);
+    }
+
+    // ── Test 4: per-symbol lists track resting orders through trades ──────
+    {
+        SymbolManager sm;
+        OrderRouter   router;
+        uint32_t seq = 1;
+        for (uint64_t oid = 100; oid < 200; ++oid) {
+            auto o = make_order(oid, SYM_GOLD, oid % 2 ? SIDE::SELL : SIDE::BUY,
+                                oid % 2 ? 210 : 200, 4, seq++);
+            feed(sm, router, o);
+        }
+        // Fill every third order completely, nick the rest
+        size_t resting = 100;
+        for (uint64_t oid = 100; oid < 200; ++oid) {
+            bool full = oid % 3 == 0;
+            auto t = make_trade(oid, oid % 2 ? 210 : 200, full ? 4 : 1, seq++);
+            feed(sm, router, t);
+            if (full) --resting;
+        }
+        check("list length = resting orders", router.symbol_size(SYM_GOLD) == resting);
+        check("router size = resting orders", router.size() == resting);
+
+        router.drop_symbol(SYM_GOLD);
+        check("drop empties the symbol",      router.symbol_size(SYM_GOLD) == 0 && router.size() == 0);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,430 @@
+#include "oe_client.h"
+#include "oe_frame_reader.h"
+#include "oe_stub_exchange.h"
+#include "order_templates.h"
+#include "spsc_queue.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // ── Test 1: SPSC queue order, bounds and wraparound ───────────────────
+    {
+        SpscQueue<uint64_t, 8> q;
+        uint64_t v = 0;
+        check("queue starts empty",  q.empty() && !q.try_pop(v));
+        for (uint64_t i = 0; i < 8; ++i) q.try_push(i);
+        check("full queue refuses",  !q.try_push(99) && q.size() == 8);
+        bool in_order = true;
+        for (uint64_t i = 0; i < 8; ++i) in_order &= q.try_pop(v) && v == i;
+        check("pops in push order",  in_order && q.empty());
+
+        for (uint64_t i = 0; i < 100; ++i) { q.try_push(i); q.try_pop(v); in_order &= v == i; }
+        check("wraps around",        in_order);
+    }
+
+    // ── Test 2: SPSC queue across threads ─────────────────────────────────
+    {
+        static SpscQueue<uint64_t, 1024> q;
+        constexpr uint64_t COUNT = 2'000'000;
+        std::thread producer([]() {
+            for (uint64_t i = 1; i <= COUNT; ++i)
+                while (!q.try_push(i)) {}
+        });
+        uint64_t expect = 1, v = 0;
+        bool in_order = true;
+        while (expect <= COUNT) {
+            if (!q.try_pop(v)) continue;
+            in_order &= v == expect;
+            ++expect;
+        }
+        producer.join();
+        check("cross-thread stream intact", in_order && q.empty());
+    }
+
+    // ── Test 3: async sends return before the exchange answers ────────────
+    {
+        OeStubExchange ex;
+        ex.response_delay = std::chrono::milliseconds(20);
+        ex.start();
+
+        OEClient oe("127.0.0.1", ex.port());
+        check("connects to stub",  oe.connect());
+        check("logs in",           oe.login("test", "test", 1));
+
+        std::atomic<uint32_t> wakes{0};
+        check("async starts",      oe.start_async([&]() { wakes.fetch_add(1); }) && oe.is_async());
+
+        std::vector<FillEvent> fills;
+        oe.set_on_fill([&](const FillEvent& f) { fills.push_back(f); });
+
+        auto t0   = Clock::now();
+        bool sent = oe.send_new_order(101, 3, SIDE::BUY, 2, 500);
+        auto took = Clock::now() - t0;
+        check("send returns immediately", sent && took < std::chrono::milliseconds(10));
+        check("nothing dispatched yet",   oe.dispatch_events() == 0 && fills.empty());
+
+        // ACK then FILL, each 20 ms apart, delivered through the queue
+        auto deadline = Clock::now() + std::chrono::seconds(2);
+        while (fills.empty() && Clock::now() < deadline) oe.dispatch_events();
+        check("fill delivered by dispatch", fills.size() == 1 && fills[0].order_id == 101
+                                           && fills[0].qty == 2 && fills[0].price == 500
+                                           && fills[0].closed);
+        check("reader woke the strategy", wakes.load() >= 2);
+
+        // The blocking helpers still work, fed from the queue
+        oe.send_new_order_no_wait(102, 3, SIDE::SELL, 1, 505);
+        check("wait_for_response via queue", oe.wait_for_response(102));
+        check("wait_for_fill via queue",     oe.wait_for_fill(102) && fills.size() == 2);
+
+        // Responses for other orders seen while waiting are applied too
+        ex.fill_orders = false;
+        oe.send_new_order_no_wait(103, 4, SIDE::BUY, 1, 90);
+        oe.send_new_order_no_wait(104, 4, SIDE::BUY, 1, 91);
+        check("out-of-order wait",           oe.wait_for_response(104));
+        std::vector<uint64_t> closed;
+        oe.set_on_close([&](uint64_t id) { closed.push_back(id); });
+        oe.cancel_all_open_orders();
+        deadline = Clock::now() + std::chrono::seconds(2);
+        while (closed.size() < 2 && Clock::now() < deadline) oe.dispatch_events();
+        check("open orders tracked from events", closed.size() == 2);
+
+        // Disconnect surfaces as an event and stops waits
+        ex.stop();
+        OeEvent ev{};
+        deadline = Clock::now() + std::chrono::seconds(2);
+        while (!oe.poll_event(ev) && Clock::now() < deadline) {}
+        check("disconnect event",            ev.type == OeEvent::Type::DISCONNECT);
+        oe.stop_async();
+        check("async stopped",               !oe.is_async());
+    }
+
+    // ── Test 4: completion handles, blocking mode ─────────────────────────
+    {
+        OeStubExchange ex;
+        ex.response_delay = std::chrono::milliseconds(5);
+        ex.start();
+
+        OEClient oe("127.0.0.1", ex.port());
+        oe.connect();
+        oe.login("test", "test", 1);
+
+        // Ten legs pipelined, then collected in one wait
+        std::vector<OrderHandle> legs;
+        for (uint64_t i = 0; i < 10; ++i)
+            legs.push_back(oe.submit_new_order(200 + i, 1 + i, SIDE::BUY, 1, 100));
+        check("handles pending before wait",   oe.order_state(legs[9])->status == OrderStatus::PENDING);
+        bool all = oe.wait_all(legs.data(), legs.size(), OrderWait::DONE,
+                               Clock::now() + std::chrono::seconds(2));
+        bool filled = true;
+        for (auto& h : legs) {
+            const OrderState* o = oe.order_state(h);
+            filled &= o && o->status == OrderStatus::FILLED && o->filled_qty == 1;
+        }
+        check("wait_all collects ten legs",    all && filled);
+
+        for (auto& h : legs) oe.release(h);
+        check("release drops done entries",    oe.open_order_count() == 0);
+
+        // A zero quantity is rejected; wait_any reports it by index
+        ex.fill_orders = false;
+        OrderHandle pair[2] = {
+            oe.submit_new_order(300, 1, SIDE::BUY, 1, 100),
+            oe.submit_new_order(301, 1, SIDE::BUY, 0, 100),
+        };
+        bool got = oe.wait_all(pair, 2, OrderWait::RESPONSE, Clock::now() + std::chrono::seconds(2));
+        const OrderState* rej = oe.order_state(pair[1]);
+        check("reject is a response",          got && rej->status == OrderStatus::REJECTED
+                                               && rej->reject_reason == (uint8_t)ndfex::oe::REJECT_REASON::INVALID_QUANTITY);
+        check("wait_any finds the done leg",   oe.wait_any(pair, 2, OrderWait::DONE, Clock::now()) == 1);
+        oe.release(pair[0]);
+        oe.release(pair[1]);
+
+        // A resting order never completes: the deadline ends the wait
+        OrderHandle rest = oe.submit_new_order(302, 1, SIDE::BUY, 1, 100);
+        auto t0 = Clock::now();
+        bool done = oe.wait_all(&rest, 1, OrderWait::DONE, t0 + std::chrono::milliseconds(100));
+        auto took = Clock::now() - t0;
+        check("deadline expires",              !done && took >= std::chrono::milliseconds(100)
+                                               && took < std::chrono::seconds(1));
+        check("resting order is live",         oe.order_state(rest)->status == OrderStatus::LIVE);
+        oe.release(rest);
+        check("released live order kept",      oe.order_state(302) != nullptr && !oe.order_state(302)->tracked);
+        oe.cancel_all_open_orders();
+        check("close drops untracked entry",   oe.open_order_count() == 0);
+        ex.stop();
+    }
+
+    // ── Test 5: completion handles, async mode ────────────────────────────
+    {
+        OeStubExchange ex;
+        ex.response_delay = std::chrono::milliseconds(2);
+        ex.start();
+
+        OEClient oe("127.0.0.1", ex.port());
+        oe.connect();
+        oe.login("test", "test", 1);
+        oe.start_async([]() {});
+
+        uint32_t fills = 0;
+        oe.set_on_fill([&](const FillEvent&) { ++fills; });
+
+        std::vector<OrderHandle> legs;
+        for (uint64_t i = 0; i < 10; ++i)
+            legs.push_back(oe.submit_new_order(400 + i, 1 + i, SIDE::SELL, 2, 100));
+        int first = oe.wait_any(legs.data(), legs.size(), OrderWait::RESPONSE,
+                                Clock::now() + std::chrono::seconds(2));
+        check("async wait_any returns a leg",  first >= 0);
+        bool all = oe.wait_all(legs.data(), legs.size(), OrderWait::DONE,
+                               Clock::now() + std::chrono::seconds(2));
+        check("async wait_all, callbacks run", all && fills == 10);
+
+        ex.stop();
+        OrderHandle lost = oe.submit_new_order(410, 1, SIDE::SELL, 1, 100);
+        check("disconnect ends the wait",      !oe.wait_all(&lost, 1, OrderWait::DONE,
+                                                            Clock::now() + std::chrono::seconds(2)));
+        oe.stop_async();
+    }
+
+    // ── Test 6: burst send ────────────────────────────────────────────────
+    {
+        OeStubExchange ex;
+        ex.start();
+
+        OEClient oe("127.0.0.1", ex.port());
+        oe.connect();
+        oe.login("test", "test", 1);
+
+        std::vector<OrderRequest> reqs;
+        for (uint64_t i = 0; i < 10; ++i)
+            reqs.push_back(OrderRequest{ 500 + i, uint32_t(1 + i), SIDE::BUY, uint32_t(1 + i), 100 });
+        std::vector<OrderHandle> handles(reqs.size());
+        oe.submit_burst(reqs.data(), reqs.size(), handles.data());
+        bool all = oe.wait_all(handles.data(), handles.size(), OrderWait::DONE,
+                               Clock::now() + std::chrono::seconds(2));
+        bool right = true;
+        for (size_t i = 0; i < reqs.size(); ++i) {
+            const OrderState* o = oe.order_state(handles[i]);
+            right &= handles[i].order_id == reqs[i].order_id && o && o->filled_qty == reqs[i].qty;
+        }
+        check("burst of ten all filled",      all && right && ex.orders_seen == 10);
+        for (auto& h : handles) oe.release(h);
+
+        // Longer than BURST_MAX: chunked, every order still framed intact
+        reqs.clear();
+        for (uint64_t i = 0; i < OEClient::BURST_MAX * 2 + 5; ++i)
+            reqs.push_back(OrderRequest{ 600 + i, 1, SIDE::SELL, 1, 100 });
+        handles.resize(reqs.size());
+        oe.submit_burst(reqs.data(), reqs.size(), handles.data());
+        all = oe.wait_all(handles.data(), handles.size(), OrderWait::DONE,
+                          Clock::now() + std::chrono::seconds(2));
+        check("chunked burst all filled",     all && ex.orders_seen == 10 + reqs.size());
+        for (auto& h : handles) oe.release(h);
+        check("burst entries released",       oe.open_order_count() == 0);
+
+        // A dead session: the first write may still be buffered, a later
+        // one fails and settles its handles on the spot
+        ex.stop();
+        OrderRequest leg[3] = { { 700, 1, SIDE::BUY, 1, 100 }, { 701, 2, SIDE::BUY, 1, 100 },
+                                { 702, 3, SIDE::BUY, 1, 100 } };
+        OrderHandle  lh[3];
+        bool failed_send = false;
+        for (int attempt = 0; attempt < 50 && !failed_send; ++attempt) {
+            failed_send = !oe.submit_burst(leg, 3, lh);
+            if (!failed_send) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        bool rejected = failed_send;
+        for (auto& h : lh) rejected &= oe.order_state(h)->status == OrderStatus::REJECTED;
+        auto t0 = Clock::now();
+        bool waited = oe.wait_all(lh, 3, OrderWait::RESPONSE, t0 + std::chrono::seconds(3));
+        check("failed burst rejects its legs", rejected);
+        check("wait on failed burst is instant", waited && Clock::now() - t0 < std::chrono::milliseconds(50));
+    }
+
+    // ── Test 7: wire templates match a fully built message ────────────────
+    {
+        OrderTemplates t;
+        t.build(9, 1234);
+
+        auto built = [](uint32_t seq, uint64_t id, uint32_t sym, SIDE side, uint32_t qty, int32_t px) {
+            ndfex::oe::new_order m{};
+            m.header.length     = sizeof(m);
+            m.header.msg_type   = (uint8_t)ndfex::oe::MSG_TYPE::NEW_ORDER;
+            m.header.version    = ndfex::oe::OE_PROTOCOL_VERSION;
+            m.header.seq_num    = seq;
+            m.header.client_id  = 9;
+            m.header.session_id = 1234;
+            m.order_id = id; m.symbol = sym; m.side = side; m.quantity = qty; m.price = px;
+            return m;
+        };
+
+        bool same = true;
+        for (uint32_t sym = 1; sym < MAX_SYMBOLS; ++sym)
+            for (SIDE side : { SIDE::BUY, SIDE::SELL }) {
+                auto want = built(sym * 7, sym + 100, sym, side, sym % 4 + 1, -50 + int32_t(sym));
+                auto& got = t.new_order(sym * 7, sym + 100, sym, side, sym % 4 + 1, -50 + int32_t(sym));
+                same &= std::memcmp(&want, &got, sizeof(want)) == 0;
+            }
+        check("new_order templates byte-exact", same);
+
+        auto& a = t.new_order(1, 1, 3, SIDE::BUY, 5, 100);
+        t.new_order(2, 2, 3, SIDE::SELL, 6, 101);
+        check("templates patch independently",  a.order_id == 1 && a.quantity == 5);
+        check("template per cache line",        reinterpret_cast<uintptr_t>(&a) % 64 == 0);
+
+        auto want = built(3, 3, 40, SIDE::BUY, 1, 1);
+        auto& spare = t.new_order(3, 3, 40, SIDE::BUY, 1, 1);
+        check("out-of-range symbol built",      std::memcmp(&want, &spare, sizeof(want)) == 0);
+
+        auto& d = t.delete_order(11, 77);
+        auto& m = t.modify_order(12, 78, SIDE::SELL, 4, 99);
+        check("delete and modify templates",    d.header.length == sizeof(d) && d.header.seq_num == 11
+                                                && d.header.session_id == 1234 && d.order_id == 77
+                                                && m.header.msg_type == (uint8_t)ndfex::oe::MSG_TYPE::MODIFY_ORDER
+                                                && m.header.client_id == 9 && m.side == SIDE::SELL
+                                                && m.quantity == 4 && m.price == 99);
+    }
+
+    // ── Test 8: framing reader over partial and batched reads ─────────────
+    {
+        int sv[2];
+        socketpair(AF_UNIX, SOCK_STREAM, 0, sv);
+        static OeFrameReader rx;
+
+        auto fill_msg = [](uint32_t seq) {
+            ndfex::oe::order_fill f{};
+            f.header.length   = sizeof(f);
+            f.header.msg_type = (uint8_t)ndfex::oe::MSG_TYPE::FILL;
+            f.header.seq_num  = seq;
+            f.order_id        = 1000 + seq;
+            f.quantity        = 1;
+            return f;
+        };
+
+        // One frame a byte at a time: nothing until the last byte
+        auto f1 = fill_msg(1);
+        size_t len = 0;
+        bool early = false;
+        for (size_t i = 0; i < sizeof(f1); ++i) {
+            send(sv[1], reinterpret_cast<char*>(&f1) + i, 1, 0);
+            rx.fill(sv[0]);
+            const char* fr = rx.next(len);
+            if (i + 1 < sizeof(f1)) early |= fr != nullptr;
+            else check("byte-wise frame completes", !early && fr && len == sizeof(f1)
+                       && reinterpret_cast<const ndfex::oe::order_fill*>(fr)->order_id == 1001);
+        }
+
+        // Many frames, one read
+        std::vector<ndfex::oe::order_fill> batch;
+        for (uint32_t i = 2; i < 52; ++i) batch.push_back(fill_msg(i));
+        send(sv[1], batch.data(), batch.size() * sizeof(batch[0]), 0);
+        rx.fill(sv[0]);
+        uint32_t got = 0;
+        while (rx.next(len)) ++got;
+        check("one read, fifty frames",     got == 50 && rx.buffered() == 0);
+
+        // A stream well past the buffer, cut at odd offsets so frames
+        // straddle reads and the compaction point
+        constexpr uint32_t N = 20'000;
+        std::vector<ndfex::oe::order_fill> stream;
+        for (uint32_t i = 0; i < N; ++i) stream.push_back(fill_msg(100 + i));
+        std::thread writer([&]() {
+            const char* p = reinterpret_cast<const char*>(stream.data());
+            size_t left = stream.size() * sizeof(stream[0]);
+            while (left) {
+                size_t n = std::min<size_t>(left, 997);
+                send(sv[1], p, n, 0);
+                p += n; left -= n;
+            }
+        });
+        uint32_t next_seq = 100;
+        bool in_order = true;
+        while (next_seq < 100 + N && rx.fill(sv[0]) > 0)
+            while (const char* fr = rx.next(len)) {
+                auto* f = reinterpret_cast<const ndfex::oe::order_fill*>(fr);
+                in_order &= len == sizeof(*f) && f->header.seq_num == next_seq && f->order_id == 1000 + next_seq;
+                ++next_seq;
+            }
+        writer.join();
+        check("straddling frames intact",   in_order && next_seq == 100 + N);
+
+        // A length that cannot be a frame stops the reader
+        ndfex::oe::oe_response_header bad{};
+        bad.length = 3;
+        send(sv[1], &bad, sizeof(bad), 0);
+        rx.fill(sv[0]);
+        check("malformed length detected",  rx.next(len) == nullptr && rx.malformed());
+
+        close(sv[1]);
+        rx.reset();
+        check("close reads as zero",        rx.fill(sv[0]) == 0);
+        close(sv[0]);
+    }
+
+    // ── Test 9: fill streams through the client ───────────────────────────
+    for (bool async : { false, true }) {
+        OeStubExchange ex;
+        ex.fills_per_order = 5000;
+        ex.start();
+
+        OEClient oe("127.0.0.1", ex.port());
+        oe.connect();
+        oe.login("test", "test", 1);
+        if (async) oe.start_async([]() {});
+
+        uint32_t fills = 0;
+        oe.set_on_fill([&](const FillEvent&) { ++fills; });
+        OrderHandle h = oe.submit_new_order(900, 3, SIDE::BUY, 5000, 100);
+        bool done = oe.wait_all(&h, 1, OrderWait::DONE, Clock::now() + std::chrono::seconds(5));
+        const OrderState* o = oe.order_state(h);
+        check(async ? "async: 5000-fill stream applied" : "sync: 5000-fill stream applied",
+              done && o->filled_qty == 5000 && o->status == OrderStatus::FILLED && fills == 5000);
+        oe.release(h);
+        oe.stop_async();
+        ex.stop();
+    }
+
+    // ── Test 10: the session log is written a buffer at a time ────────────
+    {
+        auto log_text = []() {
+            std::ifstream f("oe_log.txt");
+            return std::string(std::istreambuf_iterator<char>(f), {});
+        };
+        size_t before;
+        {
+            OeStubExchange ex;
+            ex.start();
+            before = log_text().size();
+            OEClient oe("127.0.0.1", ex.port());
+            oe.connect();
+            oe.login("test", "test", 1);
+            OrderHandle h = oe.submit_new_order(950, 3, SIDE::BUY, 1, 100);
+            oe.wait_all(&h, 1, OrderWait::RESPONSE, Clock::now() + std::chrono::seconds(2));
+            oe.release(h);
+            check("log lines held in memory", log_text().size() == before);
+            ex.stop();
+        }
+        std::string text = log_text();
+        check("log written on shutdown",    text.size() > before && text.back() == '\n'
+                                         && text.find("SENT [", before) != std::string::npos
+                                         && text.find("RECV [", before) != std::string::npos);
+        check("burst logged",               text.find("SENT BURST [") != std::string::npos);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+#include "order_router.h"
+#include <iostream>
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // ── Test 1: add / find / erase ────────────────────────────────────────
+    {
+        OrderRouter r(16);
+        r.add(1, 3);
+        r.add(2, 3);
+        r.add(3, 4);
+        check("find routes to symbol",  r.find(1) == 3 && r.find(3) == 4);
+        check("unknown id",             r.find(99) == OrderRouter::NO_SYMBOL);
+        check("per-symbol counts",      r.symbol_size(3) == 2 && r.symbol_size(4) == 1);
+
+        r.erase(1);
+        check("erased id gone",         r.find(1) == OrderRouter::NO_SYMBOL);
+        check("sibling still routed",   r.find(2) == 3);
+        check("symbol count shrinks",   r.symbol_size(3) == 1);
+    }
+
+    // ── Test 2: drop_symbol only touches that symbol ──────────────────────
+    {
+        OrderRouter r(16);
+        for (uint64_t oid = 1; oid <= 100; ++oid)
+            r.add(oid, oid % 2 ? 5 : 6);
+        r.erase(7);
+        r.erase(50);
+        r.drop_symbol(5);
+        check("dropped symbol empty",   r.symbol_size(5) == 0);
+        check("dropped ids gone",       r.find(1) == OrderRouter::NO_SYMBOL);
+        check("other symbol intact",    r.symbol_size(6) == 49 && r.find(100) == 6);
+        check("total matches",          r.size() == 49);
+
+        r.add(1, 5);
+        check("symbol reusable",        r.find(1) == 5 && r.symbol_size(5) == 1);
+    }
+
+    // ── Test 3: re-adding an id moves it between symbols ──────────────────
+    {
+        OrderRouter r(16);
+        r.add(10, 1);
+        r.add(11, 1);
+        r.add(10, 2);
+        check("re-homed",               r.find(10) == 2);
+        check("old symbol shrank",      r.symbol_size(1) == 1 && r.find(11) == 1);
+        r.drop_symbol(1);
+        check("re-homed id survives",   r.find(10) == 2);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed > 0 ? 1 : 0;
+}
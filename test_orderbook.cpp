@@ -0,0 +1,226 @@
+#include "orderbook.h"
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Built twice by the Makefile: once as the level-aggregated book and once
+// with -DORDERBOOK_ORDER_BY_ORDER. The level checks must pass in both.
+
+static uint32_t seq = 0;
+
+static new_order make_new(uint64_t id, SIDE side, int32_t price, uint32_t qty) {
+    new_order m{};
+    m.header.msg_type = MSG_TYPE::NEW_ORDER;
+    m.header.seq_num  = ++seq;
+    m.order_id = id; m.symbol = 1; m.side = side; m.price = price; m.quantity = qty;
+    return m;
+}
+
+static modify_order make_modify(uint64_t id, SIDE side, int32_t price, uint32_t qty) {
+    modify_order m{};
+    m.header.msg_type = MSG_TYPE::MODIFY_ORDER;
+    m.header.seq_num  = ++seq;
+    m.order_id = id; m.side = side; m.price = price; m.quantity = qty;
+    return m;
+}
+
+static trade make_trade(uint64_t id, uint32_t qty) {
+    trade m{};
+    m.header.msg_type = MSG_TYPE::TRADE;
+    m.header.seq_num  = ++seq;
+    m.order_id = id; m.quantity = qty;
+    return m;
+}
+
+static delete_order make_delete(uint64_t id) {
+    delete_order m{};
+    m.header.msg_type = MSG_TYPE::DELETE_ORDER;
+    m.header.seq_num  = ++seq;
+    m.order_id = id;
+    return m;
+}
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+    std::cout << "-- order-by-order book --\n";
+#else
+    std::cout << "-- level-aggregated book --\n";
+#endif
+
+    // ── Test 1: level totals through the message lifecycle ────────────────
+    {
+        OrderBook book(1);
+        auto n1 = make_new(1, SIDE::BUY, 100, 5);   book.handle_new_order(&n1);
+        auto n2 = make_new(2, SIDE::BUY, 100, 3);   book.handle_new_order(&n2);
+        auto n3 = make_new(3, SIDE::SELL, 102, 4);  book.handle_new_order(&n3);
+        check("bid level aggregates", book.get_best_bid_price() == 100 && book.get_best_bid_qty() == 8);
+        check("ask level",            book.get_best_ask_price() == 102 && book.get_best_ask_qty() == 4);
+
+        auto t1 = make_trade(1, 2);                 book.handle_trade(&t1);
+        check("trade reduces level",  book.get_best_bid_qty() == 6);
+
+        auto m2 = make_modify(2, SIDE::BUY, 101, 3); book.handle_modify_order(&m2);
+        check("modify moves level",   book.get_best_bid_price() == 101 && book.get_best_bid_qty() == 3);
+
+        auto d2 = make_delete(2);                   book.handle_delete_order(&d2);
+        check("delete restores best", book.get_best_bid_price() == 100 && book.get_best_bid_qty() == 3);
+
+        auto t3 = make_trade(3, 4);                 book.handle_trade(&t3);
+        check("full fill empties ask", book.get_best_ask_qty() == 0);
+
+        auto again = make_new(3, SIDE::SELL, 103, 1); book.handle_new_order(&again);
+        check("filled id can be reused", book.get_best_ask_price() == 103);
+        check("last seq tracked",     book.get_last_seq_num() == seq);
+    }
+
+    // ── Test 2: a reset book keeps working ────────────────────────────────
+    {
+        OrderBook book(1);
+        auto n1 = make_new(10, SIDE::SELL, 200, 7); book.handle_new_order(&n1);
+        book = OrderBook(1);
+        auto n2 = make_new(10, SIDE::SELL, 201, 2); book.handle_new_order(&n2);
+        check("reset book starts empty", book.get_best_ask_price() == 201 && book.get_best_ask_qty() == 2);
+    }
+
+    // ── Test 3: anomalies are counted, not logged ─────────────────────────
+    {
+        BookAnomalies counters;
+        OrderBook book(1, 1, &counters);
+        auto n1  = make_new(1, SIDE::BUY, 100, 5);  book.handle_new_order(&n1);
+        auto dup = make_new(1, SIDE::BUY, 101, 5);  book.handle_new_order(&dup);
+        auto z   = make_new(2, SIDE::BUY, 100, 0);  book.handle_new_order(&z);
+        auto neg = make_new(3, SIDE::BUY, -5, 1);   book.handle_new_order(&neg);
+        auto unk = make_modify(42, SIDE::BUY, 100, 1); book.handle_modify_order(&unk);
+        auto big = make_trade(1, 9);                book.handle_trade(&big);
+        auto a   = make_new(4, SIDE::SELL, 110, 1); book.handle_new_order(&a);
+        auto x   = make_new(5, SIDE::BUY, 111, 1);  book.handle_new_order(&x);
+
+        check("duplicate id counted",   counters.count(Anomaly::DUPLICATE_ID) == 1);
+        check("zero qty counted",       counters.count(Anomaly::ZERO_QTY) == 1);
+        check("negative price counted", counters.count(Anomaly::NEGATIVE_PRICE) == 1);
+        check("unknown order counted",  counters.count(Anomaly::UNKNOWN_ORDER) == 1);
+        check("over-trade counted",     counters.count(Anomaly::OVER_TRADE) == 1);
+        check("crossed counted",        counters.count(Anomaly::CROSSED) == 1);
+        check("last anomaly recorded",  counters.last_order_id.load() == 5 && counters.last_price.load() == 111);
+        check("total sums kinds",       counters.total() == 6);
+        check("rejected orders not booked", book.get_best_bid_price() == 111 && book.get_best_bid_qty() == 1);
+    }
+
+    // ── Test 4: batch snapshot load matches one-by-one replay ─────────────
+    {
+        std::mt19937 rng(7);
+        std::vector<new_order> msgs;
+        for (uint64_t id = 1; id <= 3000; ++id) {
+            bool buy = rng() & 1;
+            int32_t px = buy ? 900 + static_cast<int32_t>(rng() % 100)
+                             : 1001 + static_cast<int32_t>(rng() % 100);
+            msgs.push_back(make_new(id, buy ? SIDE::BUY : SIDE::SELL, px, 1 + rng() % 9));
+        }
+        msgs.push_back(make_new(17, SIDE::BUY, 950, 1));      // duplicate id
+        msgs.push_back(make_new(5000, SIDE::SELL, 1010, 0));  // zero qty
+        msgs.push_back(make_new(5001, SIDE::BUY, 20000, 1));  // far outlier
+
+        OrderBook replayed(1);
+        for (auto& m : msgs) replayed.handle_new_order(&m);
+
+        BookAnomalies counters;
+        OrderBook loaded(1, 1, &counters);
+        auto junk = make_new(1, SIDE::SELL, 1, 1);  loaded.handle_new_order(&junk);
+        loaded.clear();
+        check("clear empties book",     loaded.get_best_ask_qty() == 0 && loaded.get_last_seq_num() == 0);
+
+        std::vector<const new_order*> ptrs;
+        for (auto& m : msgs) ptrs.push_back(&m);
+        loaded.load_snapshot(ptrs.data(), ptrs.size());
+        check("load rejects like replay", counters.count(Anomaly::DUPLICATE_ID) == 1
+                                       && counters.count(Anomaly::ZERO_QTY) == 1);
+
+        bool same = true;
+        auto same_top = [&]() {
+            return replayed.get_best_bid_price() == loaded.get_best_bid_price()
+                && replayed.get_best_bid_qty()   == loaded.get_best_bid_qty()
+                && replayed.get_best_ask_price() == loaded.get_best_ask_price()
+                && replayed.get_best_ask_qty()   == loaded.get_best_ask_qty();
+        };
+        same = same_top();
+        check("loaded top matches",     same && loaded.get_best_bid_price() == 20000);
+        // Peel both books order by order; every level must agree
+        for (auto& m : msgs) {
+            auto d = make_delete(m.order_id);
+            replayed.handle_delete_order(&d);
+            loaded.handle_delete_order(&d);
+            if (!same_top()) same = false;
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+            auto probe = m.order_id + 1;
+            if (replayed.queue_ahead(probe) != loaded.queue_ahead(probe)) same = false;
+#endif
+        }
+        check("all levels match",       same && loaded.get_best_bid_qty() == 0);
+    }
+
+#ifdef ORDERBOOK_ORDER_BY_ORDER
+    // ── Test 5: FIFO queue position ───────────────────────────────────────
+    {
+        OrderBook book(1);
+        for (uint64_t id = 1; id <= 4; ++id) {
+            auto n = make_new(id, SIDE::BUY, 100, static_cast<uint32_t>(id * 10));
+            book.handle_new_order(&n);
+        }
+        check("head has nothing ahead", book.queue_ahead(1) == 0);
+        check("queue ahead sums FIFO",  book.queue_ahead(4) == 10 + 20 + 30);
+        check("unknown order is -1",    book.queue_ahead(99) == -1);
+        check("orders at level",        book.orders_at_level(SIDE::BUY, 100) == 4);
+
+        auto t1 = make_trade(1, 4);                 book.handle_trade(&t1);
+        check("partial fill keeps head", book.queue_ahead(2) == 6);
+
+        auto d2 = make_delete(2);                   book.handle_delete_order(&d2);
+        check("delete unlinks",         book.queue_ahead(3) == 6 && book.orders_at_level(SIDE::BUY, 100) == 3);
+
+        auto down = make_modify(3, SIDE::BUY, 100, 5); book.handle_modify_order(&down);
+        check("size-down keeps priority", book.queue_ahead(3) == 6 && book.queue_ahead(4) == 11);
+
+        auto up = make_modify(1, SIDE::BUY, 100, 50);  book.handle_modify_order(&up);
+        check("size-up goes to back",   book.queue_ahead(1) == 5 + 40);
+        check("others move up",         book.queue_ahead(3) == 0);
+
+        auto move = make_modify(3, SIDE::BUY, 99, 5);  book.handle_modify_order(&move);
+        check("reprice joins new level", book.queue_ahead(3) == 0
+                                      && book.orders_at_level(SIDE::BUY, 99) == 1
+                                      && book.orders_at_level(SIDE::BUY, 100) == 2);
+
+        auto f4 = make_trade(4, 40);                book.handle_trade(&f4);
+        auto f1 = make_trade(1, 50);                book.handle_trade(&f1);
+        check("emptied level dropped",  book.orders_at_level(SIDE::BUY, 100) == 0
+                                      && book.get_best_bid_price() == 99);
+    }
+
+    // ── Test 6: records are recycled ──────────────────────────────────────
+    {
+        OrderBook book(1);
+        for (int round = 0; round < 3; ++round) {
+            for (uint64_t id = 1; id <= 20000; ++id) {
+                auto n = make_new(id, SIDE::SELL, 100 + static_cast<int32_t>(id % 50), 1);
+                book.handle_new_order(&n);
+            }
+            for (uint64_t id = 1; id <= 20000; ++id) {
+                auto d = make_delete(id);
+                book.handle_delete_order(&d);
+            }
+        }
+        check("book drains",            book.get_best_ask_qty() == 0);
+        auto n = make_new(7, SIDE::SELL, 120, 3);  book.handle_new_order(&n);
+        check("queue valid after churn", book.queue_ahead(7) == 0 && book.orders_at_level(SIDE::SELL, 120) == 1);
+    }
+#endif
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed == 0 ? 0 : 1;
+}
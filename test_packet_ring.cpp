@@ -0,0 +1,98 @@
+#include "packet_ring.h"
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+#include <vector>
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // ── Test 1: push / front / pop keep length and order ─────────────────
+    {
+        PacketRing ring(4096);
+        check("ring mapped",         ring.valid());
+        check("starts empty",        ring.empty() && ring.count() == 0);
+
+        const char a[] = "GOIRISH!abc";
+        const char b[] = "xy";
+        ring.push(a, sizeof(a));
+        ring.push(b, sizeof(b));
+        check("two records held",    ring.count() == 2);
+        check("stored at real size",
+              ring.bytes_used() == PacketRing::record_size(sizeof(a))
+                                 + PacketRing::record_size(sizeof(b)));
+
+        uint32_t len;
+        char* p = ring.front(len);
+        check("front is oldest",     len == sizeof(a) && memcmp(p, a, len) == 0);
+        ring.pop();
+        p = ring.front(len);
+        check("then next",           len == sizeof(b) && memcmp(p, b, len) == 0);
+        ring.pop();
+        check("empty after pops",    ring.empty());
+    }
+
+    // ── Test 2: records straddling the end read back contiguously ────────
+    {
+        PacketRing ring(4096);
+        std::vector<char> pkt(1000);
+        bool intact = true;
+        for (int i = 0; i < 50; ++i) {
+            memset(pkt.data(), 'a' + (i % 26), pkt.size());
+            if (!ring.push(pkt.data(), static_cast<uint32_t>(pkt.size()))) {
+                intact = false;
+                break;
+            }
+            uint32_t len;
+            char* p = ring.front(len);
+            intact &= len == pkt.size() && memcmp(p, pkt.data(), len) == 0;
+            ring.pop();
+        }
+        check("wrapped records intact", intact);
+    }
+
+    // ── Test 3: full ring rejects, for_each visits, clear resets ─────────
+    {
+        PacketRing ring(4096);
+        char pkt[100] = {};
+        size_t pushed = 0;
+        while (ring.push(pkt, sizeof(pkt))) ++pushed;
+        check("fills to capacity",
+              pushed == ring.capacity() / PacketRing::record_size(sizeof(pkt)));
+
+        size_t visited = 0;
+        ring.for_each([&](char*, uint32_t len) { if (len == sizeof(pkt)) ++visited; });
+        check("for_each visits all", visited == pushed);
+        check("for_each consumes nothing", ring.count() == pushed);
+
+        ring.clear();
+        check("clear empties",       ring.empty() && ring.count() == 0);
+        check("usable after clear",  ring.push(pkt, sizeof(pkt)));
+    }
+
+    // ── Test 4: repeated catch-ups keep the commit bounded ───────────────
+    {
+        PacketRing ring(size_t(64) << 20);
+        char pkt[1400] = {};
+        constexpr size_t PER_CYCLE = 1000;   // ~1.4 MB buffered per catch-up
+        size_t peak = 0;
+        bool all_pushed = true;
+        for (int cycle = 0; cycle < 100; ++cycle) {
+            for (size_t i = 0; i < PER_CYCLE; ++i) all_pushed &= ring.push(pkt, sizeof(pkt));
+            peak = std::max(peak, ring.committed_bytes());
+            ring.clear();
+        }
+        size_t one_cycle = PER_CYCLE * PacketRing::record_size(sizeof(pkt));
+        check("every cycle fits",          all_pushed);
+        check("commit bounded by one cycle", peak >= one_cycle && peak <= one_cycle + 2 * 4096);
+        check("clear releases the pages",  ring.committed_bytes() == 0);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed > 0 ? 1 : 0;
+}
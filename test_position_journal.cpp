@@ -0,0 +1,142 @@
+#include "position_journal.h"
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// File layout, for corrupting records: 64-byte header, then 40-byte
+// records grouped RING_DEPTH per symbol, checksum at offset 32
+static constexpr long HEADER_BYTES = 64, RECORD_BYTES = 40, CHECKSUM_AT = 32;
+
+static long record_offset(uint32_t symbol_id, uint32_t k) {
+    return HEADER_BYTES + (symbol_id * PositionJournal::RING_DEPTH + k) * RECORD_BYTES;
+}
+
+static void poke(const std::string& path, long offset, uint32_t value) {
+    std::fstream f(path, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(offset);
+    f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    const std::string path = "test_position_journal.tmp";
+    std::remove(path.c_str());
+
+    // ── Test 1: new journal ───────────────────────────────────────────────
+    {
+        PositionJournal j;
+        check("creates missing file",   j.open(path) && j.is_open());
+        check("new journal is empty",   j.recovery().last_seq == 0 && !j.recovery().found[3]);
+    }
+
+    // ── Test 2: reopen restores the latest state ──────────────────────────
+    {
+        {
+            PositionJournal j;
+            j.open(path);
+            j.append(3, 2, -200, 200);
+            j.append(3, 5, -506, 506);
+            j.append(7, -4, 220, -220);
+            j.append(3, 1, -62, 101);
+        }
+        PositionJournal j;
+        j.open(path);
+        const auto& r = j.recovery();
+        check("latest state per symbol",    r.found[3] && r.position[3] == 1 && r.cash[3] == -62
+                                            && r.open_cost[3] == 101
+                                            && r.found[7] && r.position[7] == -4 && r.cash[7] == 220);
+        check("last sequence",              r.last_seq == 4);
+        check("untouched symbol not found", !r.found[5]);
+        check("no torn records",            r.torn == 0);
+    }
+
+    // ── Test 3: ring wraps without losing the latest state ────────────────
+    {
+        {
+            PositionJournal j;
+            j.open(path);
+            for (int i = 1; i <= 10; ++i) j.append(9, i, -50 * i, 50 * i + 1);
+        }
+        PositionJournal j;
+        j.open(path);
+        const auto& r = j.recovery();
+        check("wrapped ring keeps newest",  r.position[9] == 10 && r.cash[9] == -500
+                                            && r.open_cost[9] == 501 && r.last_seq == 14);
+        check("other symbols kept",         r.position[3] == 1 && r.position[7] == -4);
+    }
+
+    // ── Test 4: a torn record falls back to the previous one ──────────────
+    {
+        std::remove(path.c_str());
+        {
+            PositionJournal j;
+            j.open(path);
+            j.append(4, 3, -30, 30);      // ring slot 0
+            j.append(4, 6, -63, 63);      // ring slot 1
+        }
+        poke(path, record_offset(4, 1) + CHECKSUM_AT, 0xdeadbeef);
+
+        PositionJournal j;
+        j.open(path);
+        const auto& r = j.recovery();
+        check("torn record counted",        r.torn == 1);
+        check("falls back to older record", r.position[4] == 3 && r.cash[4] == -30
+                                            && r.open_cost[4] == 30);
+
+        // Next write reuses the torn slot and the good record survives
+        j.append(4, 8, -87, 87);
+        j.close();
+        PositionJournal again;
+        again.open(path);
+        check("torn slot overwritten first", again.recovery().torn == 0
+                                            && again.recovery().position[4] == 8
+                                            && again.recovery().cash[4] == -87);
+    }
+
+    // ── Test 5: fills survive kill -9 ─────────────────────────────────────
+    {
+        std::remove(path.c_str());
+        pid_t child = fork();
+        if (child == 0) {
+            PositionJournal j;
+            if (!j.open(path)) _exit(1);
+            for (int i = 1; i <= 1000; ++i) j.append(1 + i % 13, i, -100 * i, 100 * i);
+            raise(SIGKILL);   // no destructor, no munmap, no msync
+            _exit(2);
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+        check("child was killed",           WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL);
+
+        PositionJournal j;
+        check("journal opens after kill",   j.open(path));
+        const auto& r = j.recovery();
+        // i = 1000 was the last fill, on symbol 1 + 1000 % 13 = 13
+        check("last fill survived",         r.last_seq == 1000 && r.position[13] == 1000
+                                            && r.cash[13] == -100000);
+        check("every symbol's last fill",   r.position[1] == 988 && r.position[12] == 999);
+    }
+
+    // ── Test 6: foreign files are refused ─────────────────────────────────
+    {
+        std::remove(path.c_str());
+        { std::ofstream f(path); f << "3 5\n7 -2\n"; }
+        PositionJournal j;
+        check("rejects old positions.txt format", !j.open(path) && !j.is_open());
+        j.append(3, 1, -1, 1);      // closed: must not crash
+        check("append while closed is a no-op", true);
+    }
+
+    std::remove(path.c_str());
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed == 0 ? 0 : 1;
+}
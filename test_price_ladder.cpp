@@ -0,0 +1,98 @@
+#include "price_ladder.h"
+#include <iostream>
+#include <map>
+#include <random>
+#include <vector>
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // ── Test 1: best tracking on both sides ───────────────────────────────
+    {
+        PriceLadder bids(true), asks(false);
+        bids.add(100, 5);  bids.add(102, 1);  bids.add(98, 7);
+        asks.add(105, 3);  asks.add(103, 2);
+        check("best bid is highest",     bids.best_price() == 102 && bids.best_qty() == 1);
+        check("best ask is lowest",      asks.best_price() == 103 && asks.best_qty() == 2);
+
+        bids.remove(102, 1);
+        check("next bid found",          bids.best_price() == 100 && bids.best_qty() == 5);
+        bids.remove(100, 2);
+        check("partial keeps level",     bids.best_price() == 100 && bids.best_qty() == 3);
+        bids.erase_level(100);
+        bids.erase_level(98);
+        check("empty side reads zero",   bids.empty() && bids.best_price() == 0 && bids.best_qty() == 0);
+    }
+
+    // ── Test 2: re-centre and overflow keep every level ───────────────────
+    {
+        PriceLadder asks(false);
+        asks.add(1000, 1);
+        asks.add(1000 + 3000, 2);             // same window after re-centre
+        asks.add(1000 + 100000, 4);           // too far: overflow
+        asks.add(500, 8);                     // re-centre again
+        check("levels survive re-centre", asks.qty_at(1000) == 1 && asks.qty_at(4000) == 2);
+        check("far level kept",          asks.qty_at(101000) == 4);
+        check("best after re-centre",    asks.best_price() == 500);
+        asks.erase_level(500);
+        asks.erase_level(1000);
+        asks.erase_level(4000);
+        check("best falls to overflow",  asks.best_price() == 101000 && asks.best_qty() == 4);
+    }
+
+    // ── Test 3: random ops match std::map, with tick > 1 ──────────────────
+    for (bool is_bid : {true, false}) {
+        PriceLadder ladder(is_bid, 5);
+        std::map<int32_t, uint32_t> ref;
+        std::mt19937 rng(is_bid ? 1 : 2);
+        bool same = true;
+
+        for (int i = 0; i < 100000 && same; ++i) {
+            int32_t centre = 5000 + 5 * static_cast<int32_t>((i / 20000) * 900);
+            int32_t px = rng() % 50 == 0
+                ? 5 * static_cast<int32_t>(rng() % 20000)             // stray quote
+                : centre + 5 * (static_cast<int32_t>(rng() % 200) - 100);
+            if (rng() % 2) {
+                uint32_t q = 1 + rng() % 9;
+                ladder.add(px, q);
+                ref[px] += q;
+            } else if (!ref.empty()) {
+                auto it = ref.lower_bound(px);
+                if (it == ref.end()) --it;
+                uint32_t q = 1 + rng() % it->second;
+                ladder.remove(it->first, q);
+                if ((it->second -= q) == 0) ref.erase(it);
+            }
+
+            int32_t  want_px  = ref.empty() ? 0 : (is_bid ? ref.rbegin()->first : ref.begin()->first);
+            uint32_t want_qty = ref.empty() ? 0 : ref[want_px];
+            same &= ladder.best_price() == want_px && ladder.best_qty() == want_qty;
+        }
+        size_t levels = ladder.levels().size();
+        check(is_bid ? "bids match std::map" : "asks match std::map",
+              same && levels == ref.size());
+    }
+
+    // ── Test 4: bulk load matches incremental adds ────────────────────────
+    {
+        std::vector<std::pair<int32_t, uint32_t>> lv;
+        for (int32_t px = 100; px <= 200; px += 5) lv.emplace_back(px, static_cast<uint32_t>(px));
+        lv.emplace_back(90000, 3);                 // outside any window with 100
+        PriceLadder loaded(true, 5), added(true, 5);
+        loaded.add(7, 1);                           // load replaces contents
+        loaded.load(lv.data(), lv.size());
+        for (auto& [px, q] : lv) added.add(px, q);
+        check("bulk load matches adds", loaded.levels() == added.levels());
+        check("bulk load best",         loaded.best_price() == 90000 && loaded.qty_at(100) == 100);
+        loaded.remove(90000, 3);
+        check("bulk load next best",    loaded.best_price() == 200 && loaded.best_qty() == 200);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,57 @@
+#include "seqlock.h"
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+struct Quad { int32_t a; uint32_t b; int32_t c; uint32_t d; };
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // ── Test 1: single-threaded store / load ──────────────────────────────
+    {
+        SeqLock<Quad> lock;
+        Quad z = lock.load();
+        check("starts zeroed", z.a == 0 && z.b == 0 && z.c == 0 && z.d == 0);
+        uint32_t v0 = lock.version();
+        lock.store({-5, 6, 7, 8});
+        Quad q = lock.load();
+        check("round trip",        q.a == -5 && q.b == 6 && q.c == 7 && q.d == 8);
+        check("version advances",  lock.version() == v0 + 2 && lock.version() % 2 == 0);
+
+        uint32_t seq = 1;
+        check("try_load reports version", lock.try_load(q, &seq) && seq == lock.version());
+    }
+
+    // ── Test 2: concurrent reader never sees a mixed record ───────────────
+    {
+        SeqLock<Quad> lock;
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> reads{0};
+        uint64_t torn = 0;
+        lock.store({0, 0, 1, 0});
+
+        std::thread reader([&]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                Quad q = lock.load();
+                if (q.a != static_cast<int32_t>(q.b) || q.c != q.a + 1 || q.d != q.b) ++torn;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        for (uint32_t v = 1; v <= 200000; ++v) {
+            lock.store({static_cast<int32_t>(v), v, static_cast<int32_t>(v) + 1, v});
+            if (v % 1000 == 0) std::this_thread::yield();   // let the reader in on one CPU
+        }
+        stop.store(true);
+        reader.join();
+        check("no torn reads", torn == 0 && reads > 0);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed == 0 ? 0 : 1;
+}
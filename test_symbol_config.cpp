@@ -0,0 +1,88 @@
+#include "symbol_config.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+static std::string write_file(const char* name, const char* text) {
+    std::string path = std::string("/tmp/") + name;
+    std::ofstream(path) << text;
+    return path;
+}
+
+int main() {
+    int passed = 0, failed = 0;
+
+    auto check = [&](const char* name, bool cond) {
+        if (cond) { std::cout << "PASS: " << name << "\n"; ++passed; }
+        else      { std::cout << "FAIL: " << name << "\n"; ++failed; }
+    };
+
+    // ── Test 1: built-in universe ─────────────────────────────────────────
+    {
+        SymbolConfig c = SymbolConfig::defaults();
+        check("13 symbols",            c.ids().size() == 13 && c.ids().front() == SYM_GOLD
+                                    && c.ids().back() == SYM_UNDY);
+        check("names resolve",         c.find("BLUE") == SYM_BLUE && c.find("NOPE") == 0);
+        check("exchange ticks",        c.symbol(SYM_GOLD).tick == 10 && c.symbol(SYM_BLUE).tick == 5
+                                    && c.symbol(SYM_UNDY).tick == 1);
+        check("basket is 10 dorms",    c.basket().etf_id == SYM_UNDY && c.basket().legs.size() == 10
+                                    && c.basket().cash == 0
+                                    && c.basket().legs[0].symbol_id == SYM_KNAN
+                                    && c.basket().legs[0].weight == 1);
+        check("default limit",         c.symbol(SYM_KNAN).position_limit == 9);
+    }
+
+    // ── Test 2: file load ─────────────────────────────────────────────────
+    {
+        auto path = write_file("test_symbols.txt",
+            "# comment\n"
+            "symbol 21 ETF 1 5\n"
+            "symbol  3 AAA 10 9   # trailing comment\n"
+            "symbol  8 BBB 1 9\n"
+            "\n"
+            "basket ETF\n"
+            "leg BBB 4\n"
+            "leg AAA 1\n"
+            "cash -250\n");
+        SymbolConfig c = SymbolConfig::defaults();
+        check("file loads",            c.load(path));
+        check("ids sorted",            c.ids().size() == 3 && c.ids()[0] == 3 && c.ids()[2] == 21);
+        check("old universe replaced", !c.has(SYM_GOLD));
+        check("tick and limit",        c.symbol(3).tick == 10 && c.symbol(21).position_limit == 5);
+        check("legs in file order",    c.basket().etf_id == 21 && c.basket().legs.size() == 2
+                                    && c.basket().legs[0].symbol_id == 8
+                                    && c.basket().legs[0].weight == 4);
+        check("cash component",        c.basket().cash == -250);
+        std::remove(path.c_str());
+
+        check("missing file keeps config", c.load("/tmp/no_such_symbols.txt") && c.has(21));
+    }
+
+    // ── Test 3: invalid files are rejected whole ──────────────────────────
+    {
+        const char* bad[] = {
+            "symbol 32 BIG 1 9\n",                                        // id out of range
+            "symbol 1 A 1 9\nsymbol 1 B 1 9\n",                           // duplicate id
+            "symbol 1 A 0 9\n",                                           // zero tick
+            "symbol 1 A 1\n",                                             // short line
+            "symbol 1 A 1 9\nbasket A\nleg B 1\n",                        // unknown leg
+            "symbol 1 A 1 9\nsymbol 2 B 1 9\nbasket A\nleg B 0\n",        // zero weight
+            "symbol 1 A 1 9\nsymbol 2 B 1 9\nbasket A\nleg A 1\n",        // ETF in its basket
+            "symbol 1 A 1 9\nsymbol 2 B 1 9\nbasket A\n",                 // no legs
+            "frobnicate\n",                                               // unknown directive
+        };
+        bool all_rejected = true;
+        for (const char* text : bad) {
+            auto path = write_file("test_symbols_bad.txt", text);
+            SymbolConfig c = SymbolConfig::defaults();
+            if (c.load(path) || !c.has(SYM_GOLD) || c.basket().legs.size() != 10)
+                all_rejected = false;
+            std::remove(path.c_str());
+        }
+        check("bad files rejected, config kept", all_rejected);
+    }
+
+    std::cout << "\n" << passed << " passed, " << failed << " failed.\n";
+    return failed == 0 ? 0 : 1;
+}
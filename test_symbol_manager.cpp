@@ -1,6 +1,13 @@
 #include "symbol_manager.h"
+#include <fstream>
 #include <iostream>
 #include <cassert>
+#include <cstdio>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <thread>
 
 // Helper to build a minimal new_order message
 new_order make_order(uint64_t oid, uint32_t sym, SIDE side,
@@ -53,8 +60,16 @@ int main() {
 
     // ── Test 4: PnL tracking ──────────────────────────────────────────────
     {
-        // buy 3 @ 105 = -315, sell 1 @ 106 = +106 → net = -209
-        check("pnl correct", sm.get_total_pnl() == -209.0);
+        // buy 3 @ 105 = -315, sell 1 @ 106 = +106 → cash -209
+        // realized: 1 × (106 − 105) = 1; open cost 2 × 105 = 210
+        // unrealized: long 2 marked at the KNAN bid of 100 → 200 − 210 = -10
+        PnlSummary pnl = sm.symbol_pnl_summary(SYM_KNAN);
+        check("pnl cash and open cost", sm.symbol_pnl(SYM_KNAN).cash == -209
+                                     && sm.symbol_pnl(SYM_KNAN).open_cost == 210);
+        check("pnl realized",           pnl.realized == 1);
+        check("pnl unrealized at bid",  pnl.unrealized == -10);
+        check("pnl correct",            sm.get_total_pnl() == -209.0 + 2 * 100);
+        check("avg entry price",        sm.avg_entry_price(SYM_KNAN) == 105.0);
     }
 
     // ── Test 5: position limit guard ─────────────────────────────────────
@@ -69,14 +84,352 @@ int main() {
     {
         SymbolManager sm2;
         // Add asks for all 10 dorms at price 200 each → nav_ask should be 2000
-        for (uint32_t i = 0; i < DORM_IDS.size(); ++i) {
-            auto msg = make_order(100+i, DORM_IDS[i], SIDE::SELL, 200, 5, 10+i);
-            sm2.on_new_order(DORM_IDS[i], &msg);
+        const auto& legs = sm2.config().basket().legs;
+        for (uint32_t i = 0; i < legs.size(); ++i) {
+            auto msg = make_order(100+i, legs[i].symbol_id, SIDE::SELL, 200, 5, 10+i);
+            sm2.on_new_order(legs[i].symbol_id, &msg);
         }
         ArbSnapshot snap = sm2.snapshot();
         check("nav_ask correct",          snap.nav_ask == 2000);
         check("no missing asks",          !snap.any_dorm_ask_missing);
-        check("KNAN position in snapshot", snap.dorms[0].position == 0);
+        check("KNAN position in snapshot", snap.legs.position[0] == 0);
+    }
+
+    // ── Test 7: stale slot reads as untradeable until cleared ────────────
+    {
+        SymbolManager sm3;
+        for (uint32_t id = SYM_KNAN; id <= SYM_BDIN; ++id) {
+            auto msg = make_order(200+id, id, SIDE::SELL, 200, 5, 20+id);
+            sm3.on_new_order(id, &msg);
+        }
+        sm3.mark_stale(SYM_STED);
+        check("stale ask hidden",        sm3.best_ask_price(SYM_STED) == 0);
+        check("stale leg missing",       sm3.snapshot().any_dorm_ask_missing);
+
+        auto msg = make_order(300, SYM_STED, SIDE::SELL, 190, 2, 40);
+        sm3.on_new_order(SYM_STED, &msg);
+        check("stale book not published", sm3.best_ask_price(SYM_STED) == 0);
+
+        sm3.clear_stale(SYM_STED);
+        check("recovered ask published", sm3.best_ask_price(SYM_STED) == 190);
+        check("recovered leg present",   !sm3.snapshot().any_dorm_ask_missing);
+    }
+
+    // ── Test 8: top-of-book record matches the single-field reads ────────
+    {
+        SymbolManager sm4;
+        auto bid = make_order(400, SYM_GOLD, SIDE::BUY,  95, 3, 50);
+        auto ask = make_order(401, SYM_GOLD, SIDE::SELL, 97, 4, 51);
+        sm4.on_new_order(SYM_GOLD, &bid);
+        sm4.on_new_order(SYM_GOLD, &ask);
+        TopOfBook t = sm4.top_of_book(SYM_GOLD);
+        check("tob record bid", t.bid_price == 95 && t.bid_qty == 3);
+        check("tob record ask", t.ask_price == 97 && t.ask_qty == 4);
+        sm4.reset_book(SYM_GOLD);
+        t = sm4.top_of_book(SYM_GOLD);
+        check("reset clears tob", t.bid_price == 0 && t.ask_price == 0 && t.bid_qty == 0 && t.ask_qty == 0);
+    }
+
+    // ── Test 9: a batch is published as one epoch ─────────────────────────
+    {
+        SymbolManager sm5;
+        uint64_t e0 = sm5.epoch();
+        sm5.begin_batch();
+        auto a1 = make_order(500, SYM_KNAN, SIDE::SELL, 110, 1, 60);
+        auto a2 = make_order(501, SYM_STED, SIDE::SELL, 120, 1, 61);
+        sm5.on_new_order(SYM_KNAN, &a1);
+        sm5.on_new_order(SYM_STED, &a2);
+        check("batch held back",      sm5.best_ask_price(SYM_KNAN) == 0 && sm5.epoch() == e0);
+        sm5.end_batch(123456);
+        ArbSnapshot snap = sm5.snapshot();
+        check("batch published",      snap.legs.ask_price[0] == 110 && snap.legs.ask_price[1] == 120);
+        check("one epoch per batch",  snap.epoch == e0 + 1 && sm5.epoch() == e0 + 1);
+        check("feed timestamp",       snap.feed_timestamp == 123456);
+
+        sm5.begin_batch();
+        sm5.end_batch(123457);
+        check("empty batch no epoch", sm5.epoch() == e0 + 1 && sm5.snapshot().feed_timestamp == 123456);
+    }
+
+    // ── Test 10: concurrent snapshots never mix epochs ────────────────────
+    // Each batch moves KNAN and STED asks together; a snapshot that saw
+    // them differ would have read two epochs.
+    {
+        SymbolManager sm6;
+        std::atomic<bool> stop{false};
+        uint64_t mixed = 0, reads = 0;
+        std::thread reader([&]() {
+            while (!stop.load(std::memory_order_relaxed)) {
+                ArbSnapshot snap = sm6.snapshot();
+                if (snap.legs.ask_price[0] != snap.legs.ask_price[1]) ++mixed;
+                ++reads;
+            }
+        });
+        for (uint32_t i = 0; i < 20000; ++i) {
+            auto k = make_order(1000 + 2 * i, SYM_KNAN, SIDE::SELL, static_cast<int32_t>(1000 - i % 500), 1, 100 + 2 * i);
+            auto t = make_order(1001 + 2 * i, SYM_STED, SIDE::SELL, static_cast<int32_t>(1000 - i % 500), 1, 101 + 2 * i);
+            sm6.begin_batch();
+            sm6.on_new_order(SYM_KNAN, &k);
+            sm6.on_new_order(SYM_STED, &t);
+            sm6.end_batch(i);
+            if (i % 500 == 0) std::this_thread::yield();
+        }
+        stop.store(true);
+        reader.join();
+        check("no mixed-epoch snapshot", mixed == 0 && reads > 0);
+    }
+
+    // ── Test 11: incremental NAV and edges match a full re-sum ────────────
+    {
+        SymbolManager sm7;
+        ArbEdges none = sm7.edges();
+        check("no edge without legs", none.creation == ArbEdges::NO_EDGE
+                                   && none.redemption == ArbEdges::NO_EDGE);
+
+        std::mt19937 rng(11);
+        std::vector<uint64_t> live;
+        uint64_t oid = 10000;
+        uint32_t seq = 1000;
+        bool all_match = true;
+        for (int step = 0; step < 5000; ++step) {
+            uint32_t sym = 3 + rng() % 11;           // dorms and UNDY
+            if (live.empty() || rng() % 3) {
+                bool buy  = rng() & 1;
+                int32_t px = buy ? 90 + static_cast<int32_t>(rng() % 10)
+                                 : 101 + static_cast<int32_t>(rng() % 10);
+                if (sym == SYM_UNDY) px *= 10;
+                auto m = make_order(++oid, sym, buy ? SIDE::BUY : SIDE::SELL, px, 1, ++seq);
+                sm7.on_new_order(sym, &m);
+                live.push_back(oid);
+            } else {
+                // Delete a random live order from whichever book holds it
+                size_t k = rng() % live.size();
+                delete_order d{};
+                d.header.msg_type = MSG_TYPE::DELETE_ORDER;
+                d.header.seq_num  = ++seq;
+                d.order_id        = live[k];
+                for (uint32_t id = 3; id <= 13; ++id) sm7.on_delete_order(id, &d);
+                live[k] = live.back();
+                live.pop_back();
+            }
+
+            ArbSnapshot snap = sm7.snapshot();
+            int32_t nav_bid = 0, nav_ask = 0;
+            bool bid_missing = false, ask_missing = false;
+            for (size_t i = 0; i < snap.legs.count; ++i) {
+                nav_bid += snap.legs.bid_price[i];  bid_missing |= snap.legs.bid_price[i] == 0;
+                nav_ask += snap.legs.ask_price[i];  ask_missing |= snap.legs.ask_price[i] == 0;
+            }
+            BasketSums sums = snap.legs.sums();
+            int32_t creation = ask_missing || snap.undy_best_bid_price == 0
+                ? ArbEdges::NO_EDGE : snap.undy_best_bid_price - nav_ask;
+            int32_t redemption = bid_missing || snap.undy_best_ask_price == 0
+                ? ArbEdges::NO_EDGE : nav_bid - snap.undy_best_ask_price;
+            ArbEdges e = sm7.edges();
+            if (snap.nav_bid != nav_bid || snap.nav_ask != nav_ask
+                || snap.any_dorm_bid_missing != bid_missing
+                || snap.any_dorm_ask_missing != ask_missing
+                || sums.nav_bid != nav_bid || sums.nav_ask != nav_ask
+                || sums.bid_missing != snap.bid_missing_mask
+                || sums.ask_missing != snap.ask_missing_mask
+                || snap.edges.creation != creation || snap.edges.redemption != redemption
+                || e.creation != creation || e.redemption != redemption)
+                all_match = false;
+        }
+        check("incremental NAV matches re-sum", all_match);
+    }
+
+    // ── Test 12: change notification ─────────────────────────────────────
+    {
+        SymbolManager sm8;
+        uint32_t seen = sm8.change_seq();
+        sm8.take_changes();
+        auto m = make_order(20000, SYM_BLUE, SIDE::BUY, 50, 1, 5000);
+        sm8.on_new_order(SYM_BLUE, &m);
+        sm8.on_fill(SYM_KNAN, SIDE::BUY, 1, 100);
+        check("change counter bumped", sm8.change_seq() != seen);
+        check("dirty mask names symbols", sm8.take_changes() == ((1u << SYM_BLUE) | (1u << SYM_KNAN)));
+        check("mask cleared on take",  sm8.take_changes() == 0);
+
+        seen = sm8.change_seq();
+        auto t0 = std::chrono::steady_clock::now();
+        uint32_t now = sm8.wait_for_change(seen, WaitMode::SPIN_THEN_PARK, std::chrono::milliseconds(20));
+        auto waited = std::chrono::steady_clock::now() - t0;
+        check("quiet wait times out",  now == seen && waited >= std::chrono::milliseconds(20));
+
+        // A parked waiter is woken by a publication from another thread
+        for (WaitMode mode : { WaitMode::SPIN_THEN_PARK, WaitMode::BUSY_POLL }) {
+            seen = sm8.change_seq();
+            std::thread md([&]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                auto u = make_order(20001 + static_cast<uint64_t>(mode), SYM_BLUE, SIDE::SELL, 60, 1, 5001);
+                sm8.on_new_order(SYM_BLUE, &u);
+            });
+            t0  = std::chrono::steady_clock::now();
+            now = sm8.wait_for_change(seen, mode, std::chrono::seconds(5));
+            waited = std::chrono::steady_clock::now() - t0;
+            md.join();
+            check(mode == WaitMode::BUSY_POLL ? "busy poll sees update" : "parked waiter woken",
+                  now != seen && waited < std::chrono::seconds(1));
+        }
+    }
+
+    // ── Test 13: configured universe and weighted basket ──────────────────
+    {
+        SymbolConfig config;
+        config.add_symbol({ 4,  "AAA", 1, 9 });
+        config.add_symbol({ 7,  "BBB", 5, 4 });
+        config.add_symbol({ 20, "ETF", 1, 9 });
+        BasketConfig basket;
+        basket.etf_id = 20;
+        basket.legs   = { { 4, 2 }, { 7, 3 } };
+        config.set_basket(basket);
+
+        SymbolManager sm9(config);
+        check("configured ids only",   sm9.has_symbol(20) && !sm9.has_symbol(1) && !sm9.has_symbol(13));
+        check("limit from config",     sm9.position_limit(7) == 4
+                                    && sm9.would_breach_limit(7, SIDE::BUY, 5)
+                                    && !sm9.would_breach_limit(4, SIDE::BUY, 5));
+
+        auto a = make_order(30000, 4, SIDE::SELL, 100, 1, 6000);  sm9.on_new_order(4, &a);
+        auto b = make_order(30001, 7, SIDE::SELL, 50,  1, 6001);  sm9.on_new_order(7, &b);
+        auto e = make_order(30002, 20, SIDE::BUY, 400, 1, 6002);  sm9.on_new_order(20, &e);
+        ArbSnapshot snap = sm9.snapshot();
+        check("weighted nav",          snap.legs.count == 2 && snap.nav_ask == 2 * 100 + 3 * 50);
+        check("weighted edge",         sm9.edges().creation == 400 - 350);
+
+        auto b2 = make_order(30003, 7, SIDE::SELL, 45, 1, 6003);  sm9.on_new_order(7, &b2);
+        check("leg move scaled",       sm9.edges().creation == 400 - (200 + 3 * 45));
+
+        // Same basket with cash per unit: both NAVs carry it
+        basket.cash = 30;
+        config.set_basket(basket);
+        SymbolManager sm10(config);
+        sm10.on_new_order(4, &a);
+        sm10.on_new_order(7, &b);
+        sm10.on_new_order(20, &e);
+        auto lb = make_order(30004, 4, SIDE::BUY, 90, 1, 6004);  sm10.on_new_order(4, &lb);
+        auto mb = make_order(30005, 7, SIDE::BUY, 40, 1, 6005);  sm10.on_new_order(7, &mb);
+        auto ea = make_order(30006, 20, SIDE::SELL, 330, 1, 6006); sm10.on_new_order(20, &ea);
+        snap = sm10.snapshot();
+        check("cash in nav",           snap.cash == 30 && snap.nav_ask == 350 + 30
+                                    && snap.nav_bid == 2 * 90 + 3 * 40 + 30);
+        check("cash in edges",         sm10.edges().creation == 400 - 380
+                                    && sm10.edges().redemption == 330 - 330);
+        check("leg weights in snapshot", snap.legs.weight[0] == 2 && snap.legs.weight[1] == 3);
+    }
+
+    // ── Test 13b: the widest basket the universe allows ───────────────────
+    // ETF on id 1, a leg on every other id: 30 legs, past any 16-bit mask
+    {
+        SymbolConfig config;
+        config.add_symbol({ 1, "ETF", 1, 9 });
+        BasketConfig basket;
+        basket.etf_id = 1;
+        for (uint32_t id = 2; id < MAX_SYMBOLS; ++id) {
+            config.add_symbol({ id, "L" + std::to_string(id), 1, 9 });
+            basket.legs.push_back({ id, 1 });
+        }
+        check("30-leg basket accepted", config.set_basket(basket));
+
+        SymbolManager sm15(config);
+        uint32_t seq = 7000;
+        auto e = make_order(40000, 1, SIDE::BUY, 5000, 1, seq++);
+        sm15.on_new_order(1, &e);
+        for (uint32_t id = 2; id < MAX_SYMBOLS - 1; ++id) {
+            auto o = make_order(40000 + id, id, SIDE::SELL, 100, 1, seq++);
+            sm15.on_new_order(id, &o);
+        }
+        ArbSnapshot snap = sm15.snapshot();
+        check("only the last leg missing", snap.legs.count == 30
+                                        && snap.ask_missing_mask == uint64_t{1} << 29
+                                        && sm15.edges().creation == ArbEdges::NO_EDGE);
+
+        auto last = make_order(40000 + MAX_SYMBOLS - 1, MAX_SYMBOLS - 1, SIDE::SELL, 100, 1, seq++);
+        sm15.on_new_order(MAX_SYMBOLS - 1, &last);
+        snap = sm15.snapshot();
+        check("wide basket complete",   snap.ask_missing_mask == 0 && snap.nav_ask == 30 * 100
+                                     && sm15.edges().creation == 5000 - 3000
+                                     && snap.legs.sums().ask_missing == 0);
+    }
+
+    // ── Test 14: positions and PnL restored from the journal ──────────────
+    {
+        const char* path = "test_sm_journal.tmp";
+        std::remove(path);
+        {
+            SymbolManager sm11;
+            check("journal opens",     sm11.open_journal(path));
+            sm11.on_fill(3, SIDE::BUY,  4, 100);
+            sm11.on_fill(3, SIDE::SELL, 1, 110);
+            sm11.on_fill(8, SIDE::SELL, 2, 50);
+        }
+        SymbolManager sm12;
+        sm12.open_journal(path);
+        check("journal restores positions", sm12.get_position(3) == 3 && sm12.get_position(8) == -2);
+        check("journal restores pnl",       sm12.get_total_pnl() == 10.0);
+
+        sm12.on_fill(3, SIDE::SELL, 3, 105);   // closes at the restored entry price
+        check("restored entry price used",  sm12.get_total_pnl() == 25.0);
+        std::remove(path);
+    }
+
+    // ── Test 14b: a leftover positions.txt blocks a fresh journal ─────────
+    {
+        const char* path   = "test_sm_journal.tmp";
+        const char* legacy = "test_sm_positions.tmp";
+        std::remove(path);
+        { std::ofstream f(legacy); f << "3 2\n"; }
+
+        SymbolManager a;
+        check("legacy file without journal refused", !a.open_journal(path, legacy));
+        std::remove(legacy);
+        SymbolManager b;
+        check("opens once it is settled",            b.open_journal(path, legacy));
+        { std::ofstream f(legacy); f << "3 2\n"; }
+        SymbolManager c;
+        check("existing journal wins over legacy",   c.open_journal(path, legacy));
+        std::remove(legacy);
+        std::remove(path);
+    }
+
+    // ── Test 15: shorts, flips and mark-to-market ─────────────────────────
+    {
+        SymbolManager sm13;
+        sm13.on_fill(5, SIDE::SELL, 4, 200);    // short 4 @ 200
+        auto bid = make_order(40001, 5, SIDE::BUY,  190, 1, 7001);  sm13.on_new_order(5, &bid);
+        check("short without ask held at entry", sm13.pnl().unrealized == 0);
+        auto ask = make_order(40002, 5, SIDE::SELL, 195, 1, 7002);  sm13.on_new_order(5, &ask);
+        check("short marked at ask",    sm13.pnl().unrealized == 4 * (200 - 195));
+
+        sm13.on_fill(5, SIDE::BUY, 6, 196);     // cover 4 (+16), long 2 @ 196
+        SymbolPnl p = sm13.symbol_pnl(5);
+        check("flip realizes the close", sm13.pnl().realized == 16);
+        check("flip opens the rest",    p.position == 2 && p.open_cost == 2 * 196);
+        check("long marked at bid",     sm13.pnl().unrealized == 2 * (190 - 196));
+        check("near limit counts open risk", !sm13.pnl_near_limit());
+
+        sm13.on_fill(6, SIDE::BUY, 9, 1000);
+        auto crash = make_order(40003, 6, SIDE::BUY, 400, 1, 7003);  sm13.on_new_order(6, &crash);
+        check("near limit on mark alone", sm13.pnl().realized == 16 && sm13.pnl_near_limit());
+    }
+
+    // ── Test 16: PnL records are never read torn ──────────────────────────
+    {
+        SymbolManager sm14;
+        std::atomic<bool> done{false};
+        bool consistent = true;
+        std::thread reader([&]() {
+            while (!done.load(std::memory_order_acquire)) {
+                SymbolPnl p = sm14.symbol_pnl(4);
+                if (p.cash != -100 * p.position || p.open_cost != 100 * p.position) consistent = false;
+            }
+        });
+        for (int i = 0; i < 200000; ++i)
+            sm14.on_fill(4, i % 2 ? SIDE::SELL : SIDE::BUY, 1 + (i / 2) % 5, 100);
+        done.store(true, std::memory_order_release);
+        reader.join();
+        check("pnl record consistent under fills", consistent);
     }
 
     std::cout << "\n" << passed << " passed, " << failed << " failed.\n";